@@ -72,54 +72,54 @@ struct _sector{
 };
 
 
-template<typename P_TYPE> PPL_FUNC_DECL void
-_centripetal_par(const std::vector<ppl::vertex<P_TYPE>>&, 
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL void
+_centripetal_par(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
         std::vector<P_TYPE>&,
         const ppl::LERPer::_sector&);
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::vertex<P_TYPE> 
-right_tan(const std::vector<ppl::vertex<P_TYPE>>&, const uint64_t&);
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+right_tan(const std::vector<ppl::vertex<P_TYPE, DIM>>&, const uint64_t&);
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::vertex<P_TYPE> 
-left_tan(const std::vector<ppl::vertex<P_TYPE>>&, const uint64_t&);
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+left_tan(const std::vector<ppl::vertex<P_TYPE, DIM>>&, const uint64_t&);
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
-_attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>&, 
-        std::vector<ppl::vertex<P_TYPE>>&,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
+_attempt_to_fit(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>&,
         const ppl::LERPer::_sector&, 
         const ppl::LD&);
 
 
-template<typename P_TYPE> ppl::LERPer::__state<P_TYPE>
-fitSingle(const std::vector<ppl::vertex<P_TYPE>>&, 
-        std::vector<ppl::vertex<P_TYPE>>&,
+template<typename P_TYPE, std::size_t DIM> ppl::LERPer::__state<P_TYPE>
+fitSingle(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>&,
         const ppl::LD&);
 
 
-template<typename P_TYPE> PPL_FUNC_DECL void 
-_winnow(const std::vector<ppl::vertex<P_TYPE>>&,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL void 
+_winnow(const std::vector<ppl::vertex<P_TYPE, DIM>>&,
         std::vector<uint64_t>&);
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
-state_call(const std::vector<ppl::vertex<P_TYPE>>&, 
-        const ppl::vertex<P_TYPE>* const,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
+state_call(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
+        const ppl::vertex<P_TYPE, DIM>* const,
         const ppl::LERPer::_sector&);
 
 
-template<typename P_TYPE> ppl::LERPer::__state<P_TYPE>
-extractB_path(const std::vector<ppl::vertex<P_TYPE>>&, 
-        std::vector<ppl::vertex<P_TYPE>>&,
+template<typename P_TYPE, std::size_t DIM> ppl::LERPer::__state<P_TYPE>
+extractB_path(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>&,
         const ppl::LD&);
 
 
-template<typename P_TYPE> PPL_FUNC_DECL bool 
-sector_tuneUP(const std::vector<ppl::vertex<P_TYPE>>&, 
-        std::vector<ppl::vertex<P_TYPE>>&,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL bool 
+sector_tuneUP(const std::vector<ppl::vertex<P_TYPE, DIM>>&, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>&,
         ppl::LERPer::__state<P_TYPE>&,
         const ppl::LERPer::_sector&, 
         const ppl::LD&);
@@ -34,12 +34,12 @@
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
-state_call(const std::vector<ppl::vertex<P_TYPE>>& data, 
-        const ppl::vertex<P_TYPE>* const controlP,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
+state_call(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
+        const ppl::vertex<P_TYPE, DIM>* const controlP,
         const ppl::LERPer::_sector& _sec)
 {
-    ppl::cubic_path<P_TYPE> path(controlP, ppl::cubic_points);
+    ppl::cubic_path<P_TYPE, DIM> path(controlP, ppl::cubic_points);
     ppl::LERPer::__state<P_TYPE> STATE;
     for(std::size_t i{_sec.f}; i<=_sec.l; ++i){
         P_TYPE dist = path.closest_point(&data[i]).dist;
@@ -52,9 +52,9 @@ state_call(const std::vector<ppl::vertex<P_TYPE>>& data,
 }
 
 
-template<typename P_TYPE> inline ppl::LERPer::__state<P_TYPE>
-extractB_path(const std::vector<ppl::vertex<P_TYPE>>& data, 
-        std::vector<ppl::vertex<P_TYPE>>& controlP,
+template<typename P_TYPE, std::size_t DIM> inline ppl::LERPer::__state<P_TYPE>
+extractB_path(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>& controlP,
         const ppl::LD& TOLEZ)
 {
     if(data.size()<ppl::cubic_points)
@@ -107,9 +107,9 @@ extractB_path(const std::vector<ppl::vertex<P_TYPE>>& data,
 
 
 
-template<typename P_TYPE> inline ppl::LERPer::__state<P_TYPE>
-fitSingle(const std::vector<ppl::vertex<P_TYPE>>& data, 
-        std::vector<ppl::vertex<P_TYPE>>& controlP,
+template<typename P_TYPE, std::size_t DIM> inline ppl::LERPer::__state<P_TYPE>
+fitSingle(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>& controlP,
         const P_TYPE& TOLEZ) 
 {
     if(data.size()<ppl::cubic_points)
@@ -127,9 +127,9 @@ fitSingle(const std::vector<ppl::vertex<P_TYPE>>& data,
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
-_attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>& data, 
-        std::vector<ppl::vertex<P_TYPE>>& controlP,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::LERPer::__state<P_TYPE> 
+_attempt_to_fit(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>& controlP,
         const ppl::LERPer::_sector& _sec,
         const ppl::LD& TOLEZ)
 {
@@ -137,15 +137,15 @@ _attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>& data,
         ppl_invalid_argument("no enough data to fit!");
 
     controlP.resize(ppl::cubic_points);
-    ppl::vertex<P_TYPE> fitted_CP[ppl::cubic_points];
+    ppl::vertex<P_TYPE, DIM> fitted_CP[ppl::cubic_points];
     fitted_CP[0]= controlP[0] = data[_sec.f];
     fitted_CP[3]= controlP[3] = data[_sec.l]; 
 
 
-    ppl::vertex<P_TYPE> V1{left_tan(data, _sec.f)}, V2{right_tan(data, _sec.l)};
+    ppl::vertex<P_TYPE, DIM> V1{left_tan(data, _sec.f)}, V2{right_tan(data, _sec.l)};
     std::vector<P_TYPE> para(_sec.len);
     ppl::LERPer::_centripetal_par(data, para, _sec);
-    ppl::cubic_path<P_TYPE> path;
+    ppl::cubic_path<P_TYPE, DIM> path;
     ppl::LERPer::__state<P_TYPE> STATE, OUTCOME;
     double CONV{std::numeric_limits<double>::max()};
     P_TYPE P_DIST{std::numeric_limits<P_TYPE>::max()};
@@ -157,23 +157,30 @@ _attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>& data,
 
         P_TYPE C11{0}, C12{0}, C22{0}, X1{0}, X2{0};
 
-        uint64_t i{0},j{_sec.f};
-        for (i = 0; i < _sec.len; ++j, ++i)
-        {
-            ppl::vertex<P_TYPE> A1 {basisF<P_TYPE>[1](para[i]) * V1},
-                                A2 {basisF<P_TYPE>[2](para[i]) * V2};
+        // built for each instruction set, see ppl_dispatch.hpp
+        ppl::dispatch([&]{
+            const ppl::vertex<P_TYPE, DIM>* const sec_data = data.data() + _sec.f;
+            for (uint64_t i{0}; i < _sec.len; ++i)
+            {
+                // the basis of basisF, inlined
+                const P_TYPE t{para[i]}, s{1-t};
+                const P_TYPE B0{s*s*s}, B1{3*s*s*t}, B2{3*s*t*t}, B3{t*t*t};
 
-            C11 += A1.dot(A1);
-            C12 += A1.dot(A2);
-            C22 += A2.dot(A2);
+                ppl::vertex<P_TYPE, DIM> A1 {B1 * V1},
+                                    A2 {B2 * V2};
 
-            ppl::vertex<P_TYPE> V0 = data[j]
-                     - ((basisF<P_TYPE>[0](para[i]) + basisF<P_TYPE>[1](para[i])) * fitted_CP[0]
-                     +  (basisF<P_TYPE>[2](para[i]) + basisF<P_TYPE>[3](para[i])) * fitted_CP[3]);
+                C11 += A1.dot(A1);
+                C12 += A1.dot(A2);
+                C22 += A2.dot(A2);
 
-            X1 += A1.dot(V0);
-            X2 += A2.dot(V0);
-        }
+                const P_TYPE B01{B0 + B1}, B23{B2 + B3};
+                ppl::vertex<P_TYPE, DIM> V0 = ppl::fuse([&](auto d, auto c0, auto c3){ 
+                        return d - (B01 * c0 + B23 * c3); }, sec_data[i], fitted_CP[0], fitted_CP[3]);
+
+                X1 += A1.dot(V0);
+                X2 += A2.dot(V0);
+            }
+        });
 
         P_TYPE det{(C11 * C22 - C12 * C12)}; 
         P_TYPE  alph1{ static_cast<P_TYPE>((det==0.0)? 0.0 : (C22 * X1 - C12 * X2) / det) }, 
@@ -191,8 +198,9 @@ _attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>& data,
 
         path.routing(fitted_CP, ppl::cubic_points);
         STATE.ERR = 0.0;
+        uint64_t i{0},j{_sec.f};
         for (j = _sec.f , i = 0; j <= _sec.l; ++j, ++i){
-            ppl::projection<P_TYPE> C_STATE = path.closest_point(&data[j]);
+            ppl::projection<P_TYPE, DIM> C_STATE = path.closest_point(&data[j]);
             para[i] = C_STATE.parameter;
             if (C_STATE.dist > STATE.ERR){
                 STATE.ERR = C_STATE.dist;
@@ -214,8 +222,8 @@ _attempt_to_fit(const std::vector<ppl::vertex<P_TYPE>>& data,
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL void
-_centripetal_par(const std::vector<ppl::vertex<P_TYPE>>& data, 
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL void
+_centripetal_par(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
         std::vector<P_TYPE>& para,
         const ppl::LERPer::_sector& _sec) 
 {
@@ -232,8 +240,8 @@ _centripetal_par(const std::vector<ppl::vertex<P_TYPE>>& data,
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::vertex<P_TYPE> 
-right_tan(const std::vector<ppl::vertex<P_TYPE>>& data, const uint64_t& ind)
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+right_tan(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, const uint64_t& ind)
 {
     ppl_assert__(ind>0, "right tangent called on the most left data point!");
     ppl_assert__(ind<data.size(), "out of range index of right tangent!");
@@ -248,9 +256,9 @@ right_tan(const std::vector<ppl::vertex<P_TYPE>>& data, const uint64_t& ind)
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL bool 
-sector_tuneUP(const std::vector<ppl::vertex<P_TYPE>>& data, 
-        std::vector<ppl::vertex<P_TYPE>>& controlP,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL bool 
+sector_tuneUP(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, 
+        std::vector<ppl::vertex<P_TYPE, DIM>>& controlP,
         ppl::LERPer::__state<P_TYPE>& outcome,
         const ppl::LERPer::_sector& _sec,
         const ppl::LD& TOLEZ)
@@ -271,7 +279,7 @@ sector_tuneUP(const std::vector<ppl::vertex<P_TYPE>>& data,
 
     }else{
 
-        std::vector<ppl::vertex<P_TYPE>> p_container;
+        std::vector<ppl::vertex<P_TYPE, DIM>> p_container;
         outcome = ppl::LERPer::_attempt_to_fit(data, p_container, 
                         _sec, TOLEZ);
 
@@ -287,8 +295,8 @@ sector_tuneUP(const std::vector<ppl::vertex<P_TYPE>>& data,
 }
 
 
-template<typename P_TYPE> PPL_FUNC_DECL ppl::vertex<P_TYPE> 
-left_tan(const std::vector<ppl::vertex<P_TYPE>>& data, const uint64_t& ind)
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+left_tan(const std::vector<ppl::vertex<P_TYPE, DIM>>& data, const uint64_t& ind)
 {
     ppl_assert__(ind<(data.size()-1), "left tangent called on the most right data point!");
     ppl_assert__(ind>=0, "out of range index of left tangent!");
@@ -303,8 +311,8 @@ left_tan(const std::vector<ppl::vertex<P_TYPE>>& data, const uint64_t& ind)
 
 
 
-template<typename P_TYPE> PPL_FUNC_DECL
-void _winnow(const std::vector<ppl::vertex<P_TYPE>>& data,
+template<typename P_TYPE, std::size_t DIM> PPL_FUNC_DECL
+void _winnow(const std::vector<ppl::vertex<P_TYPE, DIM>>& data,
              std::vector<uint64_t>& strips)
 {
     if(data.size()<=ppl::cubic_points)
@@ -315,11 +323,12 @@ void _winnow(const std::vector<ppl::vertex<P_TYPE>>& data,
     bool dir_ch{0};
     for(uint64_t i{1}; i < data.size()-1; ++i){
 
-        if( (data[i-1].x > data[i].x)^(data[i].x > data[i+1].x) ||
-
-            (data[i-1].y > data[i].y)^(data[i].y > data[i+1].y) ||
+        bool turns{0};
+        ppl::for_each_coord<DIM>([&](auto k){ 
+            turns = turns || ( (data[i-1].template get<k>() > data[i].template get<k>())
+                              ^(data[i].template get<k>() > data[i+1].template get<k>()) ); });
 
-            (data[i-1].z > data[i].z)^(data[i].z > data[i+1].z) )
+        if(turns)
             {dir_ch^=1;}
 
         if(dir_ch){
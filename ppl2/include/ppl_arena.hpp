@@ -0,0 +1,187 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+#ifndef PPL_ARENA_HPP
+#define PPL_ARENA_HPP
+
+
+#include <mutex>
+
+#if defined(__linux__) && __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#define PPL_ARENA_MMAP
+#endif
+
+
+namespace ppl
+{
+
+/*
+ * A monotonic memory resource for the arrays of large paths. Memory is taken
+ * from the system in big chunks aligned to 2 MiB and, on Linux, the chunks
+ * are advised to be backed by transparent huge pages, which saves TLB misses
+ * when scanning paths of several GB. Deallocation is a no-op, everything is
+ * given back by release() or when the arena is destroyed, so the arena has to
+ * outlive every path allocated from it. Editing a path in place makes its
+ * arrays grow, in which case the old arrays are not reused.
+ *
+ * Allocation is serialized, so paths can be built from several threads.
+ */
+class track_arena : public std::pmr::memory_resource
+{
+    struct _chunk{
+        void* addr;
+        std::size_t size;
+        bool mapped;
+    };
+
+    static constexpr std::size_t huge_page{std::size_t(1)<<21};
+
+    std::vector<_chunk> chunks;
+    char* cursor{nullptr};
+    char* chunk_end{nullptr};
+
+    std::size_t chunk_size;
+    bool huge_pages;
+    std::size_t _reserved{0}, _used{0};
+    std::mutex _guard;
+
+
+    PPL_FUNC_DECL static std::size_t __align_up(const std::size_t& val, const std::size_t& align){
+        return (val + align - 1) / align * align;
+    }
+
+    void __new_chunk(const std::size_t& _min){
+        std::size_t size{__align_up(std::max(_min, chunk_size), huge_page)};
+        void* addr{nullptr};
+        bool mapped{0};
+
+#ifdef PPL_ARENA_MMAP
+
+        // over-map by one huge page to be able to align the chunk to it
+        void* raw = mmap(nullptr, size + huge_page, PROT_READ | PROT_WRITE, 
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(raw == MAP_FAILED)
+            throw std::bad_alloc();
+
+        char* aligned = reinterpret_cast<char*>(__align_up(reinterpret_cast<std::size_t>(raw), huge_page));
+        std::size_t head = aligned - static_cast<char*>(raw);
+        if(head)
+            munmap(raw, head);
+        munmap(aligned + size, huge_page - head);
+
+        if(huge_pages)
+            madvise(aligned, size, MADV_HUGEPAGE);
+
+        addr = aligned;
+        mapped = 1;
+#else
+        addr = ::operator new(size, std::align_val_t{huge_page});
+#endif
+
+        chunks.push_back({addr, size, mapped});
+        cursor = static_cast<char*>(addr);
+        chunk_end = cursor + size;
+        _reserved += size;
+    }
+
+protected:
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(_guard);
+
+        char* ptr = cursor == nullptr? nullptr : 
+            reinterpret_cast<char*>(__align_up(reinterpret_cast<std::size_t>(cursor), alignment));
+
+        if(ptr == nullptr || ptr + bytes > chunk_end){
+            __new_chunk(bytes + alignment);
+            ptr = reinterpret_cast<char*>(__align_up(reinterpret_cast<std::size_t>(cursor), alignment));
+        }
+
+        cursor = ptr + bytes;
+        _used += bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+
+    /*
+     * '_chunk_size' is the least amount of memory taken from the system at
+     * once, it's rounded up to a multiple of 2 MiB. Set '_huge_pages' to 0 to
+     * get regular pages, e.g. for comparing the two.
+     */
+    explicit track_arena(std::size_t _chunk_size = std::size_t(1)<<26, bool _huge_pages = 1)
+        : chunk_size{_chunk_size}, huge_pages{_huge_pages} {}
+
+    track_arena(const track_arena&) = delete;
+    track_arena& operator=(const track_arena&) = delete;
+
+    virtual ~track_arena(){ release(); }
+
+    // gives all the memory back, every path allocated from the arena must be gone
+    void release(void){
+        std::lock_guard<std::mutex> lock(_guard);
+        for(const _chunk& chunk: chunks){
+#ifdef PPL_ARENA_MMAP
+            if(chunk.mapped)
+                munmap(chunk.addr, chunk.size);
+#else
+            ::operator delete(chunk.addr, std::align_val_t{huge_page});
+#endif
+        }
+        chunks.clear();
+        cursor = chunk_end = nullptr;
+        _reserved = _used = 0;
+    }
+
+    // bytes taken from the system
+    std::size_t reserved(void) const { return _reserved; }
+
+    // bytes handed out to paths
+    std::size_t used(void) const { return _used; }
+};
+
+
+} // namespace ppl
+
+
+#endif   //  PPL_ARENA_HPP
@@ -0,0 +1,197 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_BEZIER_PATH_HPP
+#define PPL_BEZIER_PATH_HPP
+
+
+
+#include "ppl_numeric_mth.hpp"
+
+
+namespace ppl
+{
+
+/*
+ * A path of Bézier curves of the same degree 'DEGREE', stored like
+ * cubic_path "DEGREE*n+1 control points, consecutive curves share their
+ * end points".
+ *
+ * Lines "DEGREE 1" and quadratics "DEGREE 2" keep only their coefficients
+ * in power basis and are projected in closed form, without going through
+ * the quintic of the cubic solver. A track made of straight segments is
+ * thus neither degree-elevated in memory nor at every query. DEGREE 3 is
+ * cubic_path itself.
+ */
+template<typename P_TYPE, std::size_t DEGREE, std::size_t DIM = 3>
+class bezier_path : public ppl::curve_solver<P_TYPE, DIM>
+{
+    static_assert(DEGREE == 1 || DEGREE == 2, 
+        "ppl::bezier_path is defined for lines, quadratics and cubics!");
+
+    // B(t) = coeffs[0]*t^DEGREE + ... + coeffs[DEGREE]
+    struct _curve{
+        ppl::vertex<P_TYPE, DIM> coeffs[DEGREE+1];
+    };
+
+    std::pmr::vector<_curve> curves_;
+
+    using ppl::curve_solver<P_TYPE, DIM>::call_significant_fig_ascertain;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_line;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_quadratic;
+
+
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+    solve_for(const _curve& c, const P_TYPE& t) const {
+        if constexpr (DEGREE == 1)
+            return c.coeffs[0]*t + c.coeffs[1];
+        else
+            return (c.coeffs[0]*t + c.coeffs[1])*t + c.coeffs[2];
+    }
+
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> 
+    tangent_at(const _curve& c, const P_TYPE& t) const {
+        if constexpr (DEGREE == 1){
+            (void)t;
+            return c.coeffs[0];
+        }
+        else
+            return 2*t*c.coeffs[0] + c.coeffs[1];
+    }
+
+    PPL_FUNC_DECL bool project(const _curve& c, const ppl::vertex<P_TYPE, DIM>& p, 
+                    P_TYPE& min_dist, P_TYPE& _param) const
+    {
+        if constexpr (DEGREE == 1)
+            return project_on_line(c.coeffs[1], c.coeffs[0], p, min_dist, _param);
+        else
+            return project_on_quadratic(c.coeffs[0], c.coeffs[1], c.coeffs[2], 
+                                    p, min_dist, _param);
+    }
+
+public:
+
+    explicit bezier_path(std::pmr::memory_resource* __resource = std::pmr::get_default_resource()):
+            curves_(__resource)
+    {
+        ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
+            "instantiation of ppl::bezier_path can only be with floating-point types!\n");
+    }
+
+    bezier_path(const ppl::vertex<P_TYPE, DIM>* const points, 
+            const uint64_t& _size): bezier_path() {
+        routing(points, _size);
+    }
+
+
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size)
+    {
+        ppl_assert__( (_size -1)%DEGREE == 0 && _size > DEGREE, 
+                    "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        curves_.resize((_size-1)/DEGREE);
+        for(uint64_t i{0}; i<curves_.size(); ++i)
+        {
+            const ppl::vertex<P_TYPE, DIM>* const c = points + i*DEGREE;
+            if constexpr (DEGREE == 1)
+                curves_[i] = _curve{{ c[1] - c[0], c[0] }};
+            else
+                curves_[i] = _curve{{ c[0] - 2*c[1] + c[2], 2*(c[1] - c[0]), c[0] }};
+        }
+    }
+
+
+    PPL_FUNC_DECL ppl::projection<P_TYPE, DIM> 
+    closest_point(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        ppl_assert__(!curves_.empty(), 
+            "closest point was called on empty data! did you forget to load your data?\n");
+
+        ppl::projection<P_TYPE, DIM> point_projection;
+        point_projection.index = 0;
+        point_projection.parameter = 0;
+
+        P_TYPE min_dist{(*p).sqr_dist(curves_[0].coeffs[DEGREE])}, curr_dist;
+
+        for(uint64_t i{0}; i<curves_.size(); ++i)
+        {
+            curr_dist = (*p).sqr_dist(solve_for(curves_[i], static_cast<P_TYPE>(1)));
+            if (min_dist > curr_dist){
+                point_projection.index = i;
+                point_projection.parameter = static_cast<P_TYPE>(1);
+                min_dist = curr_dist;
+            }
+
+            if(project(curves_[i], *p, min_dist, point_projection.parameter))
+                point_projection.index = i;
+        }
+
+        const _curve& c = curves_[point_projection.index];
+        point_projection.closest = solve_for(c, point_projection.parameter);
+        point_projection.dist = point_projection.closest.dist(*p);
+        point_projection.tan = tangent_at(c, point_projection.parameter);
+        return point_projection;
+    }
+
+
+    uint64_t curves(void) const { return curves_.size(); }
+
+    // bytes per curve against cubic_path<P_TYPE>::bytes_per_curve()
+    static constexpr std::size_t bytes_per_curve(void) {
+        return sizeof(_curve);
+    }
+
+    std::size_t footprint(void) const {
+        return sizeof(_curve)*curves_.capacity();
+    }
+
+};
+
+
+template<typename P_TYPE, std::size_t DIM>
+class bezier_path<P_TYPE, ppl::cubic, DIM> : public ppl::cubic_path<P_TYPE, DIM>
+{
+public:
+    using ppl::cubic_path<P_TYPE, DIM>::cubic_path;
+};
+
+} // namespace ppl
+
+#endif //  PPL_BEZIER_PATH_HPP
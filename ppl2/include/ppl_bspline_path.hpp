@@ -0,0 +1,247 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_BSPLINE_PATH_HPP
+#define PPL_BSPLINE_PATH_HPP
+
+
+
+#include "ppl_numeric_mth.hpp"
+
+
+namespace ppl
+{
+
+/*
+ * A read-only path given as a uniform cubic B-spline: n+3 de Boor points
+ * for n spans, against 3n+1 control points for the same path in Bézier
+ * form. Only the de Boor points are kept "or none at all, see
+ * borrow_points_t"; the monomial coefficients of a span are built from
+ * its four de Boor points when the span is visited by a query, and the
+ * span is then projected on by the same solver as cubic_path.
+ *
+ * A span lies in the convex hull of its de Boor points, so the spans whose
+ * bounding sphere is farther than the best distance found so far are
+ * skipped before their coefficients are built.
+ *
+ * projection.index is the index of the span, and projection.parameter its
+ * local parameter in [0, 1].
+ */
+template<typename P_TYPE, std::size_t DIM = 3>
+class bspline_path : public ppl::curve_solver<P_TYPE, DIM>
+{
+
+    std::pmr::vector<ppl::vertex<P_TYPE, DIM>> owned;
+    const ppl::vertex<P_TYPE, DIM>* de_boor{nullptr};
+    uint64_t spans_{0};
+
+    using ppl::curve_solver<P_TYPE, DIM>::monomial_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::call_significant_fig_ascertain;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_curve;
+    using ppl::curve_solver<P_TYPE, DIM>::poly3d_solve_for;
+    using ppl::curve_solver<P_TYPE, DIM>::deriv3d_solve_for;
+
+
+    // the point of span 'i' at t = 0, which is also the end of span i-1
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> knot_point(const uint64_t& i) const {
+        return ppl::fuse([](auto q0, auto q1, auto q2){ 
+            return (q0 + 4*q1 + q2) / static_cast<P_TYPE>(6); }, de_boor[i], de_boor[i+1], de_boor[i+2]);
+    }
+
+    PPL_FUNC_DECL void span_coeffs(const uint64_t& i, 
+                ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
+    {
+        const ppl::vertex<P_TYPE, DIM>* const q = de_boor + i;
+        monomial_coeffs(
+            ppl::fuse([](auto q0, auto q1, auto q2, auto q3){ 
+                return (3*(q1 - q2) + q3 - q0) / static_cast<P_TYPE>(6); }, q[0], q[1], q[2], q[3]),
+            ppl::fuse([](auto q0, auto q1, auto q2){ 
+                return (q0 + q2) / static_cast<P_TYPE>(2) - q1; }, q[0], q[1], q[2]),
+            ppl::fuse([](auto q0, auto q2){ 
+                return (q2 - q0) / static_cast<P_TYPE>(2); }, q[0], q[2]),
+            knot_point(i), _parametric, _deriv, _poly);
+    }
+
+    // 1 if no point of span 'i' can be closer to 'p' than 'min_dist' "squared distance"
+    PPL_FUNC_DECL bool out_of_reach(const uint64_t& i, 
+                const ppl::vertex<P_TYPE, DIM>& p, const P_TYPE& min_dist) const
+    {
+        const ppl::vertex<P_TYPE, DIM>* const q = de_boor + i;
+        const ppl::vertex<P_TYPE, DIM> centre{(q[0] + q[1] + q[2] + q[3]) / static_cast<P_TYPE>(4)};
+        P_TYPE radius{0};
+        for(uint32_t j{0}; j<ppl::cubic_points; ++j)
+            radius = std::max(radius, q[j].sqr_dist(centre));
+
+        const P_TYPE gap{p.dist(centre) - std::sqrt(radius)};
+        return gap > 0 && gap*gap >= min_dist;
+    }
+
+    void __routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, bool _borrow)
+    {
+        ppl_assert__(_size > ppl::cubic, "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        if(_borrow){
+            owned.clear();
+            owned.shrink_to_fit();
+            de_boor = points;
+        }
+        else{
+            owned.assign(points, points+_size);
+            de_boor = owned.data();
+        }
+        spans_ = _size - ppl::cubic;
+    }
+
+public:
+
+    explicit bspline_path(std::pmr::memory_resource* __resource = std::pmr::get_default_resource()):
+            owned(__resource)
+    {
+        ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
+            "instantiation of ppl::bspline_path can only be with floating-point types!\n");
+    }
+
+    bspline_path(const ppl::vertex<P_TYPE, DIM>* const points, 
+            const uint64_t& _size): bspline_path() {
+        routing(points, _size);
+    }
+
+    bspline_path(const ppl::vertex<P_TYPE, DIM>* const points, 
+            const uint64_t& _size, ppl::borrow_points_t): bspline_path() {
+        routing(points, _size, ppl::borrow_points);
+    }
+
+    // a copy borrows the same points when this path does
+    bspline_path(const bspline_path& other): bspline_path(other.owned.get_allocator().resource()) {
+        *this = other;
+    }
+
+    bspline_path& operator=(const bspline_path& other){
+        if(this != &other){
+            owned = other.owned;
+            de_boor = other.owned.empty()? other.de_boor : owned.data();
+            spans_ = other.spans_;
+        }
+        return *this;
+    }
+
+
+    // copies the n+3 de Boor points of a path of n spans
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size){
+        __routing(points, _size, 0);
+    }
+
+    // the points stay with the caller and must outlive the path
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::borrow_points_t){
+        __routing(points, _size, 1);
+    }
+
+
+    PPL_FUNC_DECL ppl::projection<P_TYPE, DIM> 
+    closest_point(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        ppl_assert__(spans_ > 0, 
+            "closest point was called on empty data! did you forget to load your data?\n");
+
+        ppl::projection<P_TYPE, DIM> point_projection;
+        point_projection.index = 0;
+        point_projection.parameter = 0;
+
+        ppl::poly3d<P_TYPE, DIM> _parametric;
+        ppl::deriv3d<P_TYPE, DIM> _deriv;
+        ppl::poly1d<P_TYPE> _poly;
+        ppl::solver_scratch<P_TYPE, ALTERS_PRECISION> scratch;
+
+        P_TYPE min_dist{(*p).sqr_dist(knot_point(0))}, curr_dist;
+
+        for(uint64_t i{0}; i<spans_; ++i)
+        {
+            if(out_of_reach(i, *p, min_dist))
+                continue;
+
+            curr_dist = (*p).sqr_dist(knot_point(i+1));
+            if (min_dist > curr_dist){
+                point_projection.index = i;
+                point_projection.parameter = static_cast<P_TYPE>(1);
+                min_dist = curr_dist;
+            }
+
+            span_coeffs(i, _parametric, _deriv, _poly);
+            if(project_on_curve(_parametric, _deriv, _poly, *p, 
+                            min_dist, point_projection.parameter, scratch))
+                point_projection.index = i;
+        }
+
+        span_coeffs(point_projection.index, _parametric, _deriv, _poly);
+        point_projection.closest = poly3d_solve_for(_parametric, point_projection.parameter);
+        point_projection.dist = point_projection.closest.dist(*p);
+        point_projection.tan = deriv3d_solve_for(_deriv, point_projection.parameter);
+        return point_projection;
+    }
+
+
+    uint64_t spans(void) const { return spans_; }
+
+    bool is_borrowed(void) const { return spans_ > 0 && owned.empty(); }
+
+    // the Bézier control points of span 'i', e.g. to feed a cubic_path
+    void bezier_points(const uint64_t& i, ppl::vertex<P_TYPE, DIM> _points[ppl::cubic_points]) const
+    {
+        ppl_assert__(i < spans_, "out of range span!");
+        const ppl::vertex<P_TYPE, DIM>* const q = de_boor + i;
+        _points[0] = knot_point(i);
+        _points[1] = (2*q[1] + q[2]) / static_cast<P_TYPE>(3);
+        _points[2] = (q[1] + 2*q[2]) / static_cast<P_TYPE>(3);
+        _points[3] = knot_point(i+1);
+    }
+
+    std::size_t footprint(void) const {
+        return sizeof(ppl::vertex<P_TYPE, DIM>)*owned.capacity();
+    }
+
+};
+
+} // namespace ppl
+
+#endif //  PPL_BSPLINE_PATH_HPP
@@ -0,0 +1,142 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_DISPATCH_HPP
+#define PPL_DISPATCH_HPP
+
+
+#include "ppl_headers.hpp"
+
+#if defined(PPL_CPU_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) \
+        && (defined(__x86_64__) || defined(__i386__))
+#define PPL_DISPATCH_X86
+#elif defined(PPL_CPU_DISPATCH)
+#warning "PPL_CPU_DISPATCH is only supported by gcc and clang on x86, the kernels are built once!"
+#endif
+
+
+namespace ppl
+{
+
+/*
+ * Runtime selection of the hot kernels "the curve scan of a projection,
+ * the coefficients of a path and the accumulation of a fit" on x86. With
+ * PPL_CPU_DISPATCH every kernel is built three times, for the baseline the
+ * project is compiled with "SSE2 on x86-64", for AVX2 with FMA and for
+ * AVX-512, and the best one the CPU runs is chosen the first time a kernel
+ * is called. So a single binary built without any '-march' still uses the
+ * wide registers where they exist. Everything a kernel calls is inlined
+ * into each of its builds.
+ *
+ * Without the macro, or on other compilers and targets, a kernel is just
+ * called.
+ */
+enum class isa_level : uint8_t { baseline, avx2, avx512 };
+
+
+#ifdef PPL_DISPATCH_X86
+
+#define PPL_TARGET_AVX2 __attribute__((target("avx2,fma"), flatten))
+#define PPL_TARGET_AVX512 \
+        __attribute__((target("avx512f,avx512vl,avx512dq,avx512bw,avx2,fma"), flatten))
+
+inline isa_level detect_isa(void)
+{
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") 
+            && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw"))
+        return isa_level::avx512;
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return isa_level::avx2;
+    return isa_level::baseline;
+}
+
+template<typename kernel_t> PPL_TARGET_AVX2 void __avx2_kernel(kernel_t& kernel){ kernel(); }
+template<typename kernel_t> PPL_TARGET_AVX512 void __avx512_kernel(kernel_t& kernel){ kernel(); }
+
+#else
+
+inline isa_level detect_isa(void){ return isa_level::baseline; }
+
+#endif
+
+
+inline isa_level& __isa(void)
+{
+    static isa_level level{detect_isa()};
+    return level;
+}
+
+// the build of the kernels in use
+inline isa_level cpu_isa(void){ return __isa(); }
+
+/*
+ * Lowers the build of the kernels to 'level', e.g. to compare them, or
+ * raises it back up to what the CPU supports. Not to be called while
+ * queries are running.
+ */
+inline void limit_isa(const isa_level level){ __isa() = std::min(level, detect_isa()); }
+
+inline const char* isa_name(const isa_level level)
+{
+    switch(level){
+        case isa_level::avx512: return "avx512";
+        case isa_level::avx2: return "avx2";
+        default: return "baseline";
+    }
+}
+
+
+// calls 'kernel' "a lambda" in the build selected for the CPU
+template<typename kernel_t> PPL_FORCEINLINE void dispatch(kernel_t&& kernel)
+{
+#ifdef PPL_DISPATCH_X86
+    switch(cpu_isa()){
+        case isa_level::avx512: return __avx512_kernel(kernel);
+        case isa_level::avx2: return __avx2_kernel(kernel);
+        default: break;
+    }
+#endif
+    kernel();
+}
+
+
+} // namespace ppl
+
+
+#endif // PPL_DISPATCH_HPP
@@ -53,6 +53,10 @@
 #include <type_traits>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <utility>
 #include <stdio.h>
 #include <errno.h>
 
@@ -86,7 +90,7 @@ typedef double ALTERS_PRECISION;
 
 
 
-CONST LD eps{ 1e-17L };
+constexpr LD eps{ 1e-17L };
 CONST UNS quintic{5};
 CONST UNS quartic{4};
 CONST UNS quintic_Coeffs{6};
@@ -96,6 +100,7 @@ CONST UNS cubic_Coeffs{4};
 CONST UNS quadratic{2};
 CONST UNS quadratic_Coeffs{3};
 CONST UNS IT_OVR_FLW{3'000};
+CONST UNS alloc_alignment{64};   // arrays of a path start on a cache line
     
 		
 		
@@ -107,7 +112,7 @@ CONST UNS IT_OVR_FLW{3'000};
  * always defined and initialized by a 'long double' value. Therefore if
      * needed please change the value only and not the type.
  */
-    CONST LD TOLERANCE(0.00001L);
+    constexpr LD TOLERANCE(0.00001L);
 
 
 
@@ -173,7 +178,6 @@ namespace fs = std::experimental::filesystem::v1;
 #include <memory>
 
 // #include <numeric>
-#include "ppl_pthlib.hpp"
 #include <cstdlib>
 
 
@@ -192,6 +196,8 @@ namespace fs = std::experimental::filesystem::v1;
 
 #endif
 
+#include "ppl_pthlib.hpp"
+
 #endif
 
 
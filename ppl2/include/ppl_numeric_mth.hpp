@@ -39,31 +39,29 @@
 #define PPL_NUMERIC_MTH_HPP
 
 #include "ppl_skelets.hpp"
+#include "ppl_dispatch.hpp"
 
 #include <initializer_list>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <math.h>
 
 namespace ppl{
 
 
 
-template<typename P_TYPE>
-class cubic_path
+/*
+ * The numerics shared by all kinds of paths: building the coefficients of a
+ * single cubic Bézier curve from its control points, and projecting a point
+ * on that curve by isolating the real roots of the quintic equation. Curves
+ * of a lower degree (lines and degree-elevated quadratics) are projected in
+ * closed form instead.
+ */
+template<typename P_TYPE, std::size_t DIM = 3>
+class curve_solver
 {    
-
-    ppl::vertex<P_TYPE> (*splines)[ppl::cubic_points]{nullptr}; 
-
-    ppl::vertex<P_TYPE>* control_points{nullptr};
-
-    ppl::poly1d<P_TYPE>* polys{nullptr};
-
-    ppl::poly3d<P_TYPE>* parametric{nullptr};
-    ppl::deriv3d<P_TYPE>* deriv{nullptr};
-    
-    uint64_t poly_num{0};
-    uint64_t points_num{0};
-
+protected:
 
     const P_TYPE TOLERZ{
         static_cast<P_TYPE>(ppl::TOLERANCE<ppl::eps? ppl::eps:ppl::TOLERANCE)
@@ -76,57 +74,248 @@ class cubic_path
 
     const uint32_t min_depth{ppl::quintic};
 
+    // squared relative size under which the leading coefficient of a curve is rounding noise
+    const P_TYPE DEGREE_EPS{static_cast<P_TYPE>(
+        64*std::numeric_limits<P_TYPE>::epsilon() * 64*std::numeric_limits<P_TYPE>::epsilon())};
 
-    const std::function<const P_TYPE(const uint64_t&)> 
-        object_poly_coeffs[ppl::quintic_Coeffs]={ 
-            [this](const uint64_t& i) -> const P_TYPE {return  -3 *  parametric[i].coeffs[0].dot(parametric[i].coeffs[0]); } ,
-            [this](const uint64_t& i) -> const P_TYPE {return (-5 *  parametric[i].coeffs[0].dot(parametric[i].coeffs[1]))  / polys[i].coeffs[0]; },
-            [this](const uint64_t& i) -> const P_TYPE {return (-4 *  parametric[i].coeffs[0].dot(parametric[i].coeffs[2])
-                                                               -2 *  parametric[i].coeffs[1].dot(parametric[i].coeffs[1]) ) / polys[i].coeffs[0]; },
-            [this](const uint64_t& i) -> const P_TYPE {return  -3 * (parametric[i].coeffs[0].dot(parametric[i].coeffs[3])
-                                                                   + parametric[i].coeffs[1].dot(parametric[i].coeffs[2]) ) / polys[i].coeffs[0]; },
-            [this](const uint64_t& i) -> const P_TYPE {return (-2 *  parametric[i].coeffs[1].dot(parametric[i].coeffs[3])
-                                                                   - parametric[i].coeffs[2].dot(parametric[i].coeffs[2]) ) / polys[i].coeffs[0]; },
-            [this](const uint64_t& i) -> const P_TYPE {return       -parametric[i].coeffs[2].dot(parametric[i].coeffs[3])   / polys[i].coeffs[0]; }
-        };
 
+    /*
+     * A curve whose cubic coefficient 'a' is negligible next to the others
+     * is a quadratic, a line or a single point, e.g. a straight segment
+     * given with evenly spaced control points.
+     */
+    PPL_FUNC_DECL bool is_cubic(const P_TYPE& aa, const P_TYPE& bb, 
+                const P_TYPE& cc, const P_TYPE& dd) const {
+        return aa > DEGREE_EPS*(bb + cc + dd);
+    }
 
-    void extract_poly(const uint64_t& _stride, const ppl::vertex<P_TYPE>* const points)
+    // drops the cubic term and leaves the quintic zero, which marks the curve for project_on_quadratic
+    PPL_FUNC_DECL void lower_degree(ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
     {
+        _parametric.coeffs[0] = static_cast<P_TYPE>(0);
+        _deriv.coeffs[0] = static_cast<P_TYPE>(0);
+        for(uint32_t i{0}; i<ppl::quintic_Coeffs; ++i)
+            _poly.coeffs[i] = 0;
+    }
 
-        uint32_t i{0};
-        for(i=0; i<ppl::cubic_points; ++i)
-            parametric[_stride].coeffs[i] = ppl::parametric_coeffs<P_TYPE>[i](points);
+    /*
+     * The quintic of a cubic curve, the squared norms of its first three
+     * coefficients are those the degree test has already computed.
+     */
+    PPL_FUNC_DECL static void object_coeffs(const ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                const P_TYPE& aa, const P_TYPE& bb, const P_TYPE& cc, 
+                ppl::poly1d<P_TYPE>& _poly)
+    {
+        const ppl::vertex<P_TYPE, DIM>* const c = _parametric.coeffs;
+        const P_TYPE lead = -3*aa;
+        _poly.coeffs[0] = lead;
+        _poly.coeffs[1] = (-5*c[0].dot(c[1])) / lead;
+        _poly.coeffs[2] = (-4*c[0].dot(c[2]) - 2*bb) / lead;
+        _poly.coeffs[3] = -3*(c[0].dot(c[3]) + c[1].dot(c[2])) / lead;
+        _poly.coeffs[4] = (-2*c[1].dot(c[3]) - cc) / lead;
+        _poly.coeffs[5] = -c[2].dot(c[3]) / lead;
+    }
 
-        if(parametric[_stride].coeffs[0] == 0.0) 
-            throw_arg_exception(_stride, points);
+    // returns 0 if the curve is of a lower degree, see lower_degree
+    PPL_FUNC_DECL bool extract_coeffs(const ppl::vertex<P_TYPE, DIM>* const points,
+                ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
+    {
+        ppl::vertex<P_TYPE, DIM>* const c = _parametric.coeffs;
+        c[0] = ppl::fuse([](auto p0, auto p1, auto p2, auto p3){ 
+                return 3*(p1-p2) + p3-p0; }, points[0], points[1], points[2], points[3]);
+        c[1] = ppl::fuse([](auto p0, auto p1, auto p2){ 
+                return 3*(p0+p2) - 6*p1; }, points[0], points[1], points[2]);
+        c[2] = ppl::fuse([](auto p0, auto p1){ 
+                return 3*(p1-p0); }, points[0], points[1]);
+        c[3] = points[0];
+
+        _deriv.coeffs[0] = 3*c[0];
+        _deriv.coeffs[1] = 2*c[1];
+        _deriv.coeffs[2] = c[2];
+
+        const P_TYPE aa = c[0].dot(c[0]), bb = c[1].dot(c[1]), cc = c[2].dot(c[2]);
+        if(!is_cubic(aa, bb, cc, c[3].dot(c[3]))){
+            lower_degree(_parametric, _deriv, _poly);
+            return 0;
+        }
 
-        for(i=0; i<ppl::cubic; ++i)
-            deriv[_stride].coeffs[i] = (ppl::cubic-i) * parametric[_stride].coeffs[i];
+        object_coeffs(_parametric, aa, bb, cc, _poly);
+        return 1;
+    }
 
-        for(i=0;i<ppl::quintic_Coeffs; ++i)
-            polys[_stride].coeffs[i] = object_poly_coeffs[i](_stride);
+    /*
+     * Same coefficients as extract_coeffs, written out so they can be
+     * recomputed inside the query loop.
+     */
+    PPL_FUNC_DECL void recompute_coeffs(const ppl::vertex<P_TYPE, DIM>* const points,
+                ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
+    {
+        const ppl::vertex<P_TYPE, DIM>& d = points[0];
+        const ppl::vertex<P_TYPE, DIM> a = ppl::fuse([](auto p0, auto p1, auto p2, auto p3){ 
+                return 3*(p1-p2) + p3-p0; }, points[0], points[1], points[2], points[3]);
+        const ppl::vertex<P_TYPE, DIM> b = ppl::fuse([](auto p0, auto p1, auto p2){ 
+                return 3*(p0+p2) - 6*p1; }, points[0], points[1], points[2]);
+        const ppl::vertex<P_TYPE, DIM> c = ppl::fuse([](auto p0, auto p1){ 
+                return 3*(p1-p0); }, points[0], points[1]);
+
+        monomial_coeffs(a, b, c, d, _parametric, _deriv, _poly);
+    }
 
+    // the same from the monomial form 'a*t^3 + b*t^2 + c*t + d' of a curve
+    PPL_FUNC_DECL void monomial_coeffs(const ppl::vertex<P_TYPE, DIM>& a, 
+                const ppl::vertex<P_TYPE, DIM>& b, 
+                const ppl::vertex<P_TYPE, DIM>& c, 
+                const ppl::vertex<P_TYPE, DIM>& d, 
+                ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
+    {
+        _parametric.coeffs[0] = a;
+        _parametric.coeffs[1] = b;
+        _parametric.coeffs[2] = c;
+        _parametric.coeffs[3] = d;
+
+        _deriv.coeffs[0] = 3*a;
+        _deriv.coeffs[1] = 2*b;
+        _deriv.coeffs[2] = c;
+
+        const P_TYPE aa = a.dot(a), bb = b.dot(b), cc = c.dot(c);
+        if(!is_cubic(aa, bb, cc, d.dot(d))){
+            lower_degree(_parametric, _deriv, _poly);
+            return;
+        }
+
+        const P_TYPE lead = -3*aa, inv = 1/lead;
+        _poly.coeffs[0] = lead;
+        _poly.coeffs[1] = -5*a.dot(b) * inv;
+        _poly.coeffs[2] = (-4*a.dot(c) - 2*bb) * inv;
+        _poly.coeffs[3] = -3*(a.dot(d) + b.dot(c)) * inv;
+        _poly.coeffs[4] = (-2*b.dot(d) - cc) * inv;
+        _poly.coeffs[5] = -c.dot(d) * inv;
     }
 
-    void throw_arg_exception(const std::size_t ind, 
-            const ppl::vertex<P_TYPE>* const points) const 
+    /*
+     * The real roots of c3*t^3 + c2*t^2 + c1*t + c0 in closed form, written
+     * to 'roots'. Returns their number. Leading coefficients which vanish
+     * lower the degree of the equation.
+     */
+    PPL_FUNC_DECL static uint8_t cubic_roots(const P_TYPE& c3, const P_TYPE& c2, 
+                const P_TYPE& c1, const P_TYPE& c0, P_TYPE roots[ppl::cubic])
     {
+        const P_TYPE scale{std::abs(c2) + std::abs(c1) + std::abs(c0)};
+        const P_TYPE _eps{64*std::numeric_limits<P_TYPE>::epsilon()};
+
+        if(std::abs(c3) <= _eps*scale){
+            if(std::abs(c2) <= _eps*(std::abs(c1) + std::abs(c0))){
+                if(c1 == 0)
+                    return 0;
+                roots[0] = -c0/c1;
+                return 1;
+            }
 
-        // out << "9-0-0870";
-        std::string err = "control points are on top of each other!\nstarting from the "
-                    + std::to_string((ind * ppl::cubic)+1) 
-                    + "'th control point:\n";
+            const P_TYPE disc{c1*c1 - 4*c2*c0};
+            if(disc < 0)
+                return 0;
+            // no cancellation between c1 and the root of the discriminant
+            const P_TYPE q{static_cast<P_TYPE>(-0.5)*(c1 + (c1 < 0? -1 : 1)*std::sqrt(disc))};
+            roots[0] = q/c2;
+            if(q == 0)
+                return 1;
+            roots[1] = c0/q;
+            return 2;
+        }
 
-        for(std::size_t i{0}; i < ppl::cubic_points; ++i ){
-            err+=std::to_string(i + (ind * ppl::cubic) +1);
-            err += *(points+i);
+        const P_TYPE A{c2/c3}, B{c1/c3}, C{c0/c3};
+        const P_TYPE Q{(A*A - 3*B)/9}, R{(2*A*A*A - 9*A*B + 27*C)/54};
+        const P_TYPE QQQ{Q*Q*Q};
+
+        if(R*R < QQQ){   // three real roots
+            const P_TYPE theta{std::acos(R/std::sqrt(QQQ))}, sQ{-2*std::sqrt(Q)};
+            const P_TYPE third{static_cast<P_TYPE>(2.09439510239319549230842892218633526)};   // 2*pi/3
+            roots[0] = sQ*std::cos(theta/3) - A/3;
+            roots[1] = sQ*std::cos(theta/3 + third) - A/3;
+            roots[2] = sQ*std::cos(theta/3 - third) - A/3;
+            return 3;
         }
 
-        std::cerr<< err << "\n";
-        ppl_invalid_argument("invalid argument");
+        P_TYPE U{-std::cbrt(std::abs(R) + std::sqrt(R*R - QQQ))};
+        if(R < 0)
+            U = -U;
+        roots[0] = (U + (U == 0? 0 : Q/U)) - A/3;
+        return 1;
     }
 
+    /*
+     * Looks for the closest point to 'p' in the interior of the segment
+     * 'origin + t*dir', same contract as project_on_curve.
+     */
+    PPL_FUNC_DECL bool project_on_line(const ppl::vertex<P_TYPE, DIM>& origin, 
+                const ppl::vertex<P_TYPE, DIM>& dir, 
+                const ppl::vertex<P_TYPE, DIM>& p, 
+                P_TYPE& min_dist, P_TYPE& _param) const
+    {
+        const P_TYPE len{dir.dot(dir)};
+        if(len == 0)
+            return 0;
+
+        const P_TYPE t{(p - origin).dot(dir)/len};
+        if(!(t > 0 && t < 1))   // the end points are the caller's
+            return 0;
+        const P_TYPE curr_dist{p.sqr_dist(origin + t*dir)};
+        if(min_dist > curr_dist){
+            _param = t;
+            min_dist = curr_dist;
+            return 1;
+        }
+        return 0;
+    }
+
+    /*
+     * Same as project_on_curve for the quadratic 'a2*t^2 + a1*t + a0'. The
+     * squared distance is stationary at the roots of a cubic, which is solved
+     * in closed form.
+     */
+    PPL_FUNC_DECL bool project_on_quadratic(const ppl::vertex<P_TYPE, DIM>& a2, 
+                const ppl::vertex<P_TYPE, DIM>& a1, 
+                const ppl::vertex<P_TYPE, DIM>& a0, 
+                const ppl::vertex<P_TYPE, DIM>& p, 
+                P_TYPE& min_dist, P_TYPE& _param) const
+    {
+        const P_TYPE aa{a2.dot(a2)}, bb{a1.dot(a1)};
+        if(aa <= DEGREE_EPS*(bb + a0.dot(a0)))
+            return project_on_line(a0, a1, p, min_dist, _param);
+
+        // the curve is inside the hull of its control points, so inside the
+        // sphere centred between its end points that holds all three of them
+        const ppl::vertex<P_TYPE, DIM> rel{a0 - p}, half{a1/2 + a2/2};
+        const P_TYPE gap{std::sqrt((rel + half).dot(rel + half)) 
+                - std::sqrt(std::max(half.dot(half), (half - a1/2).dot(half - a1/2)))};
+        if(gap > 0 && gap*gap >= min_dist)
+            return 0;
+
+        P_TYPE roots[ppl::cubic];
+        const uint8_t _rN{cubic_roots(2*aa, 3*a2.dot(a1), 
+                            bb + 2*a2.dot(rel), a1.dot(rel), roots)};
+
+        bool closer{0};
+        for(uint8_t j{0}; j<_rN; ++j){
+            if(!(roots[j] > 0 && roots[j] < 1))
+                continue;
+            const P_TYPE curr_dist{p.sqr_dist((roots[j]*a2 + a1)*roots[j] + a0)};
+            if(min_dist > curr_dist){
+                _param = roots[j];
+                min_dist = curr_dist;
+                closer = 1;
+            }
+        }
+        return closer;
+    }
 
     void call_significant_fig_ascertain(void) {
 
@@ -160,8 +349,7 @@ __pragma(warning(pop))
         
     } 
 
-    PPL_FUNC_DECL bool newton_mth(const ppl::default_precision_polys<P_TYPE, 
-                                    ALTERS_PRECISION>& lead_polys, 
+    PPL_FUNC_DECL bool newton_mth(ALTERS_PRECISION const * const obj_poly, 
                                 P_TYPE val, 
                                 const P_TYPE a, const P_TYPE b, 
                                 ppl::real_roots<P_TYPE>& roots) const
@@ -171,15 +359,13 @@ __pragma(warning(pop))
 
         for (std::size_t i{0};;++i)
         {   
-            polyEvalu = poly1d_solve_for(lead_polys.poly[0], val); 
+            polyEvalu = quintic_solve_for(obj_poly, val, derivEvalu); 
 
             if ( std::abs( polyEvalu ) <= TOLERZ){
                 roots.push(val);
                 return 0;
             }
 
-            derivEvalu = poly1d_solve_for(lead_polys.poly[1], val);
-
             if ( derivEvalu == 0.0 || i > NEWTON_THRES)  //  <<<<<<<<<<<<<<<< NEWTON'S METHOD FAILED!!  
                 return 1;  // >>>>>> throw local maximum/minimum || iteration overflow!
 
@@ -192,10 +378,15 @@ __pragma(warning(pop))
     }
 
 
+    /*
+     * The six coefficients whose sign variations num_alters_at counts, the
+     * quintic 'coeffs' with (a, b) mapped onto (0, inf).
+     */
     template<typename alters_t>
-    PPL_FUNC_DECL uint8_t num_alters_at
+    PPL_FUNC_DECL static void alters_terms
                 (alters_t const * const coeffs,
-                const alters_t& a, const alters_t& b) const 
+                const alters_t& a, const alters_t& b, 
+                alters_t terms[ppl::quintic_Coeffs])
     {
         
         alters_t aa[4], bb[4];
@@ -211,119 +402,230 @@ __pragma(warning(pop))
             coeff_5+=bb[i]*coeffs[j];
         }
 
-        alters_t l1[16]{a*b, aa[0]*b, aa[1]*b, 3.0*aa[0], 4.0*a, aa[0]*bb[0],
-                        4.0*b, a*bb[1], 3.0*bb[0], aa[2]*b, aa[1]*bb[0],
-                        aa[0]*bb[1], a*bb[2], 5.0*coeffs[5], 10.0*coeffs[5], a*bb[0] };
-        alters_t l2[7]{4.0*l1[2], 3.0*l1[1], 2.0*l1[0], 6.0*l1[5], 3.0*l1[15],
-                        6.0*l1[0], 4.0*l1[7]};
+        alters_t l1[16]{a*b, aa[0]*b, aa[1]*b, 3*aa[0], 4*a, aa[0]*bb[0],
+                        4*b, a*bb[1], 3*bb[0], aa[2]*b, aa[1]*bb[0],
+                        aa[0]*bb[1], a*bb[2], 5*coeffs[5], 10*coeffs[5], a*bb[0] };
+        alters_t l2[7]{4*l1[2], 3*l1[1], 2*l1[0], 6*l1[5], 3*l1[15],
+                        6*l1[0], 4*l1[7]};
+
+        terms[0] = coeff_0;
+        terms[1] = coeffs[0]*5*l1[9]
+                 + coeffs[1]*(aa[2]+l2[0])
+                 + coeffs[2]*(2*aa[1]+l2[1])
+                 + coeffs[3]*(l1[3]+l2[2])
+                 + coeffs[4]*(l1[4]+b) + l1[13];
+        terms[2] = coeffs[0]*10*l1[10]
+                 + coeffs[1]*(l2[0]+l2[3]) 
+                 + coeffs[2]*(aa[1]+6*l1[1]+l2[4])
+                 + coeffs[3]*(l1[3]+l2[5]+bb[0])
+                 + coeffs[4]*(6*a+l1[6]) + l1[14];
+        terms[3] = coeffs[0]*10*l1[11]
+                 + coeffs[1]*(l2[3]+l2[6])
+                 + coeffs[2]*(l2[1]+6*l1[15]+bb[1])
+                 + coeffs[3]*(aa[0]+l2[5]+l1[8])
+                 + coeffs[4]*(l1[4]+6*b) + l1[14];
+        terms[4] = coeffs[0]*5*l1[12]
+                 + coeffs[1]*(l2[6]+bb[2])
+                 + coeffs[2]*(l2[4]+2*bb[1])
+                 + coeffs[3]*(l2[2]+l1[8])
+                 + coeffs[4]*(a+l1[6]) + l1[13];
+        terms[5] = coeff_5;
+    }
+
+    template<typename alters_t>
+    PPL_FUNC_DECL uint8_t num_alters_at
+                (alters_t const * const coeffs,
+                const alters_t& a, const alters_t& b) const 
+    {
+        alters_t terms[ppl::quintic_Coeffs];
+        alters_terms(coeffs, a, b, terms);
 
         uint8_t alters{0};
-        bool priv{std::signbit(coeff_0)}, 
-           curr{std::signbit( coeffs[0]*5.0*l1[9]
-                            + coeffs[1]*(aa[2]+l2[0])
-                            + coeffs[2]*(2.0*aa[1]+l2[1])
-                            + coeffs[3]*(l1[3]+l2[2])
-                            + coeffs[4]*(l1[4]+b) + l1[13] )};
-        alters+=(priv^curr);
-        priv = curr;
-        curr =  std::signbit( coeffs[0]*10.0*l1[10]
-                            + coeffs[1]*(l2[0]+l2[3]) 
-                            + coeffs[2]*(aa[1]+6.0*l1[1]+l2[4])
-                            + coeffs[3]*(l1[3]+l2[5]+bb[0])
-                            + coeffs[4]*(6.0*a+l1[6]) + l1[14] );
-        alters+=(priv^curr);
-        priv = curr;
-        curr =  std::signbit( coeffs[0]*10.0*l1[11]
-                            + coeffs[1]*(l2[3]+l2[6])
-                            + coeffs[2]*(l2[1]+6.0*l1[15]+bb[1])
-                            + coeffs[3]*(aa[0]+l2[5]+l1[8])
-                            + coeffs[4]*(l1[4]+6.0*b) + l1[14] );
-        alters+=(priv^curr);
-        priv = curr;
-        curr =  std::signbit( coeffs[0]*5.0*l1[12]
-                            + coeffs[1]*(l2[6]+bb[2])
-                            + coeffs[2]*(l2[4]+2.0*bb[1])
-                            + coeffs[3]*(l2[2]+l1[8])
-                            + coeffs[4]*(a+l1[6]) + l1[13] );
-        alters+=(priv^curr);
-        
-        return (alters+=(curr^std::signbit(coeff_5)));
+        for(uint8_t j{1}; j<ppl::quintic_Coeffs; ++j)
+            alters+=(std::signbit(terms[j-1])^std::signbit(terms[j]));
+        return alters;
     }
 
-
-template<typename alters_t>
-    inline void __split(alters_t const * const obj_poly,
-                const ppl::default_precision_polys<P_TYPE, 
-                        ALTERS_PRECISION>& __polys, 
-                const alters_t a, const alters_t b, 
-                const uint8_t _rN, 
-                ppl::real_roots<P_TYPE>& roots,
-                uint32_t curr_depth) const
+#ifdef PPL_MIXED_PRECISION_ALTERS
+    /*
+     * num_alters_at in float. Every term is evaluated a second time on the
+     * absolute values of the coefficients "a and b are in [0, 1]", which
+     * bounds its rounding error. If a term is within that bound of zero
+     * its sign is not certain, 0 is returned and 'alters' is left as is.
+     */
+    PPL_FUNC_DECL bool certified_alters_at
+                (ALTERS_PRECISION const * const coeffs,
+                const ALTERS_PRECISION& a, const ALTERS_PRECISION& b, 
+                uint8_t& alters) const 
     {
-        if ((b - a) <= TOLERZ){
-            roots.push( static_cast<P_TYPE>( (a + b) / 2.0) ); 
-            return;
+        // no more than 16 roundings on the way to a term, the conversions included
+        constexpr float rel_err{16*std::numeric_limits<float>::epsilon()};
+
+        float f_coeffs[ppl::quintic_Coeffs], abs_coeffs[ppl::quintic_Coeffs];
+        for(uint8_t j{0}; j<ppl::quintic_Coeffs; ++j){
+            f_coeffs[j] = static_cast<float>(coeffs[j]);
+            abs_coeffs[j] = std::abs(f_coeffs[j]);
         }
+        const float f_a{static_cast<float>(a)}, f_b{static_cast<float>(b)};
+
+        float terms[ppl::quintic_Coeffs], bounds[ppl::quintic_Coeffs];
+        alters_terms(f_coeffs, f_a, f_b, terms);
+        alters_terms(abs_coeffs, f_a, f_b, bounds);
+
+        bool certain{1};   // NaN and inf never are
+        for(uint8_t j{0}; j<ppl::quintic_Coeffs; ++j)
+            certain &= std::abs(terms[j]) > 
+                rel_err*bounds[j] + std::numeric_limits<float>::min();
+        if(!certain)
+            return 0;
+
+        alters = 0;
+        for(uint8_t j{1}; j<ppl::quintic_Coeffs; ++j)
+            alters+=(std::signbit(terms[j-1])^std::signbit(terms[j]));
+        return 1;
+    }
+#endif
 
-        if (_rN == 1)
-        {
+    /*
+     * The sign variations of the quintic 'coeffs' in (a, b), see
+     * num_alters_at. With PPL_MIXED_PRECISION_ALTERS they are counted in
+     * float first, and again in ALTERS_PRECISION only when that count is
+     * not certain.
+     */
+    PPL_FUNC_DECL uint8_t count_alters
+                (ALTERS_PRECISION const * const coeffs,
+                const ALTERS_PRECISION& a, const ALTERS_PRECISION& b) const 
+    {
+#ifdef PPL_MIXED_PRECISION_ALTERS
+        uint8_t alters;
+        if(certified_alters_at(coeffs, a, b, alters))
+            return alters;
+#endif
+        return num_alters_at(coeffs, a, b);
+    }
 
-            P_TYPE _a{static_cast<P_TYPE>(a)}, _b{static_cast<P_TYPE>(b)};
-            P_TYPE r_evalu{poly1d_solve_for(__polys.poly[0], _b)};
-            
-            if ( poly1d_solve_for(__polys.poly[0], _a) < 0.0 && r_evalu > 0.0)
-            {
-                /*
-                    Newton's method is extremely fast to find a root, 
-                    but if it FOR VERY RARE SITUATION failed to find a root in a certain number of iterations, 
-                    then more likely it'll not find a root at all, or it could tend toward a wrong root!
-                    For some situations such as oscillating sequence it's a must to change 
-                    the initial value by shrinking the interval using Bisection method.
-                    
-                */
-                P_TYPE m_val{(_a+_b) / 2};
-                for(;curr_depth<min_depth;++curr_depth){
-                    if (ppl::__sign(poly1d_solve_for(__polys.poly[0], m_val)) == ppl::__sign(r_evalu)){
-                        _b = m_val;
-                        r_evalu = poly1d_solve_for(__polys.poly[0], _b);
-                    }
-                    else _a = m_val;
 
-                    m_val = (_a+_b) / 2;
-               }
+    /*
+     * Isolates the real roots of 'scratch.obj' in the open interval (0, 1)
+     * "which has '_rN' sign variations" by bisection and pushes them to
+     * 'scratch.roots'. The intervals are kept in 'scratch.pending' instead
+     * of on the call stack.
+     */
+    PPL_FUNC_DECL void __split(ppl::solver_scratch<P_TYPE, ALTERS_PRECISION>& scratch, 
+                const uint8_t _rN) const
+    {
+        using interval = typename ppl::solver_scratch<P_TYPE, ALTERS_PRECISION>::interval;
 
-                for(;newton_mth(__polys, m_val, _a, _b, roots);){
+        const ALTERS_PRECISION* const obj_poly = scratch.obj;
+        ppl::real_roots<P_TYPE>& roots = scratch.roots;
 
-                    if (ppl::__sign(poly1d_solve_for(__polys.poly[0], m_val)) == ppl::__sign(r_evalu)){
-                        _b = m_val;
-                        r_evalu = poly1d_solve_for(__polys.poly[0], _b);
-                    }
-                    else _a = m_val;
+        // the interval at hand stays out of 'pending', which only holds the ones put aside
+        interval curr{0.0, 1.0, 1, _rN};
+        uint32_t top{0};
 
-                    m_val = (_a+_b) / 2;
+        for(;;)
+        {
+            const ALTERS_PRECISION a{curr.a}, b{curr.b};
 
-                    if ((_b - _a) <= TOLERZ){
-                        roots.push( m_val ); 
-                        return;
+            if ((b - a) <= TOLERZ)
+                roots.push( static_cast<P_TYPE>( (a + b) / 2.0) ); 
+            else if (curr.alters == 1)
+            {
+                uint32_t curr_depth{curr.depth};
+                P_TYPE _a{static_cast<P_TYPE>(a)}, _b{static_cast<P_TYPE>(b)};
+                P_TYPE r_evalu{quintic_solve_for(obj_poly, _b)};
+                
+                if ( quintic_solve_for(obj_poly, _a) < 0.0 && r_evalu > 0.0)
+                {
+                    /*
+                        Newton's method is extremely fast to find a root, 
+                        but if it FOR VERY RARE SITUATION failed to find a root in a certain number of iterations, 
+                        then more likely it'll not find a root at all, or it could tend toward a wrong root!
+                        For some situations such as oscillating sequence it's a must to change 
+                        the initial value by shrinking the interval using Bisection method.
+                        
+                    */
+                    P_TYPE m_val{(_a+_b) / 2};
+                    for(;curr_depth<min_depth;++curr_depth){
+                        if (ppl::__sign(quintic_solve_for(obj_poly, m_val)) == ppl::__sign(r_evalu)){
+                            _b = m_val;
+                            r_evalu = quintic_solve_for(obj_poly, _b);
+                        }
+                        else _a = m_val;
+
+                        m_val = (_a+_b) / 2;
+                   }
+
+                    for(;newton_mth(obj_poly, m_val, _a, _b, roots);){
+
+                        if (ppl::__sign(quintic_solve_for(obj_poly, m_val)) == ppl::__sign(r_evalu)){
+                            _b = m_val;
+                            r_evalu = quintic_solve_for(obj_poly, _b);
+                        }
+                        else _a = m_val;
+
+                        m_val = (_a+_b) / 2;
+
+                        if ((_b - _a) <= TOLERZ){
+                            roots.push( m_val ); 
+                            break;
+                        }
                     }
                 }
+                
+            }else {
+                const ALTERS_PRECISION m_value = (a+b) / 2.0;
+                const uint32_t depth{curr.depth+1};
+                const uint8_t rootsN1{count_alters(obj_poly, m_value, b)},
+                        rootsN2{count_alters(obj_poly, a, m_value)};
+
+                // the upper half is taken first
+                if( rootsN1 >= 1 ){
+                    if(rootsN2 >= 1) 
+                        scratch.pending[top++] = interval{a, m_value, depth, rootsN2};
+                    curr = interval{m_value, b, depth, rootsN1};
+                    continue;
+                }
+                if(rootsN2 >= 1){
+                    curr = interval{a, m_value, depth, rootsN2};
+                    continue;
+                }
             }
-            
-        }else {
-            alters_t m_value = (a+b) / 2.0;
-            ++curr_depth;
-            uint8_t rootsN1{num_alters_at(obj_poly, m_value, b)},
-                    rootsN2{num_alters_at(obj_poly, a, m_value)};
-
-            if( rootsN1 >= 1 )
-                __split(obj_poly, __polys, m_value, b, rootsN1, roots, curr_depth);
 
-            if(rootsN2 >= 1) 
-                __split(obj_poly, __polys, a, m_value, rootsN2, roots, curr_depth);
+            if(!top)
+                return;
+            curr = scratch.pending[--top];
         }
     }
 
  
+    /*
+     * The monic quintic 'obj_poly' at 'val' in P_TYPE, by Horner's rule.
+     * The second overload carries the derivative along the same pass, see
+     * newton_mth.
+     */
+    PPL_FUNC_DECL static P_TYPE quintic_solve_for
+            (ALTERS_PRECISION const * const obj_poly, const P_TYPE& val)
+    {
+        P_TYPE result = static_cast<P_TYPE>(obj_poly[0]);
+        for(uint8_t i{1}; i<ppl::quintic_Coeffs; ++i)
+            result = result*val + static_cast<P_TYPE>(obj_poly[i]);
+        return result;
+    }
+
+    PPL_FUNC_DECL static P_TYPE quintic_solve_for
+            (ALTERS_PRECISION const * const obj_poly, const P_TYPE& val, 
+            P_TYPE& deriv)
+    {
+        P_TYPE result = static_cast<P_TYPE>(obj_poly[0]);
+        deriv = 0;
+        for(uint8_t i{1}; i<ppl::quintic_Coeffs; ++i){
+            deriv = deriv*val + result;
+            result = result*val + static_cast<P_TYPE>(obj_poly[i]);
+        }
+        return result;
+    }
+
     PPL_FUNC_DECL P_TYPE poly1d_solve_for
             (const ppl::poly1d<P_TYPE>& poly,
             const P_TYPE& val) const
@@ -337,184 +639,947 @@ template<typename alters_t>
         return result;
     }
 
-    PPL_FUNC_DECL ppl::vertex<P_TYPE> poly3d_solve_for
-            (const ppl::poly3d<P_TYPE>& poly, 
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> poly3d_solve_for
+            (const ppl::poly3d<P_TYPE, DIM>& poly, 
             const P_TYPE& val) const{
 
         return val*(val*(val*poly.coeffs[0]
                 +poly.coeffs[1])+poly.coeffs[2]) + poly.coeffs[3];
     }
 
-    PPL_FUNC_DECL ppl::vertex<P_TYPE> deriv3d_solve_for
-            (const ppl::deriv3d<P_TYPE>& poly, 
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> deriv3d_solve_for
+            (const ppl::deriv3d<P_TYPE, DIM>& poly, 
             const P_TYPE& val) const{
 
         return val*(val*poly.coeffs[0]+poly.coeffs[1])+poly.coeffs[2];
     }
 
-    PPL_FUNC_DECL void _call_projection(ppl::vertex<P_TYPE> const * const p, 
-                ppl::projection<P_TYPE> * const point_projection) const
+    /*
+     * The roots of the quintic 'obj_poly' "with '_rN' sign variations in
+     * (0, 1)" closer to 'p' than 'min_dist', see project_on_curve.
+     */
+    PPL_FUNC_DECL bool __isolate(const ALTERS_PRECISION obj_poly[ppl::quintic_Coeffs], 
+                const uint8_t _rN, 
+                const ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                const ppl::vertex<P_TYPE, DIM>& p, 
+                P_TYPE& min_dist, P_TYPE& _param, 
+                ppl::solver_scratch<P_TYPE, ALTERS_PRECISION>& scratch) const
+    {
+        bool closer{0};
+
+        ppl::real_roots<P_TYPE>& roots = scratch.roots;
+        roots.clear();
+
+        uint8_t j{0};
+        for(; j<ppl::quintic_Coeffs; ++j)
+            scratch.obj[j] = obj_poly[j];
+
+        __split(scratch, _rN);
+
+        for (j=0; j < roots.num; ++j){
+            P_TYPE curr_dist = p.sqr_dist(poly3d_solve_for(_parametric, 
+                                        roots.zeros[j]));
+            if (min_dist > curr_dist){
+                _param = roots.zeros[j];
+                min_dist = curr_dist;
+                closer = 1;
+            }
+        }
+
+        return closer;
+    }
+
+    /*
+     * Looks for the closest point to 'p' in the interior of a single curve.
+     * If there is one closer than 'min_dist' "squared distance", 'min_dist'
+     * and '_param' are updated and 1 is returned. 'scratch' is shared by
+     * all the curves of a query.
+     */
+    PPL_FUNC_DECL bool project_on_curve(const ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                const ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                const ppl::poly1d<P_TYPE>& _poly,
+                const ppl::vertex<P_TYPE, DIM>& p, 
+                P_TYPE& min_dist, P_TYPE& _param, 
+                ppl::solver_scratch<P_TYPE, ALTERS_PRECISION>& scratch) const
+    {
+        if(_poly.coeffs[0] == 0)   // see lower_degree
+            return project_on_quadratic(_parametric.coeffs[1], _parametric.coeffs[2], 
+                                _parametric.coeffs[3], p, min_dist, _param);
+
+        ALTERS_PRECISION obj_poly[ppl::quintic_Coeffs];
+        obj_poly[0] = 1;
+        for(uint8_t j{1}; j<ppl::quintic_Coeffs; ++j)
+            if(j<ppl::cubic)
+                obj_poly[j] = _poly.coeffs[j];
+            else
+                obj_poly[j] = _poly.coeffs[j] 
+                + (_deriv.coeffs[j-ppl::cubic].dot(p) / _poly.coeffs[0]);
+
+        // most curves have no root and are screened out here
+        const uint8_t _rN{count_alters(obj_poly, 0.0, 1.0)};
+        if (_rN == 0)
+            return 0;
+
+        return __isolate(obj_poly, _rN, _parametric, p, min_dist, _param, scratch);
+    }
+
+};
+
+
+
+template<typename P_TYPE, std::size_t DIM = 3>
+class cubic_path : public ppl::curve_solver<P_TYPE, DIM>
+{    
+
+    /*
+     * Each control point is stored once "3n+1 layout", consecutive curves
+     * share their end points. Curve i starts at control_points[3*i].
+     */
+    ppl::vertex<P_TYPE, DIM>* control_points{nullptr};
+    bool borrowed{0};   // 'control_points' belong to the caller
+    bool lean{0};       // no coefficients are kept, every query recomputes them
+    bool lazy{0};       // the coefficients of a tile are computed by the first query reaching it
+    bool viewed{0};     // all the arrays belong to the caller, see view()
+
+    /*
+     * A lazy path groups its curves in tiles of LAZY_TILE curves, each
+     * bounded by a sphere holding its control points. The first query the
+     * sphere doesn't rule out claims the tile, computes its coefficients and
+     * publishes them; concurrent queries wait for them.
+     */
+    static constexpr uint64_t LAZY_TILE{256};
+    enum : uint8_t { tile_bounded, tile_busy, tile_ready };
+
+    struct _lazy_tile{
+        ppl::vertex<P_TYPE, DIM> centre;
+        P_TYPE radius;
+        std::atomic<uint8_t> state;
+    };
+
+    _lazy_tile* tiles{nullptr};
+
+    // where all the arrays of the path are allocated from
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
+
+    ppl::poly1d<P_TYPE>* polys{nullptr};
+
+    ppl::poly3d<P_TYPE, DIM>* parametric{nullptr};
+    ppl::deriv3d<P_TYPE, DIM>* deriv{nullptr};
+    
+    uint64_t poly_num{0};
+    uint64_t points_num{0};
+    uint64_t poly_cap{0};
+
+    using ppl::curve_solver<P_TYPE, DIM>::extract_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::recompute_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::call_significant_fig_ascertain;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_curve;
+    using ppl::curve_solver<P_TYPE, DIM>::poly3d_solve_for;
+    using ppl::curve_solver<P_TYPE, DIM>::deriv3d_solve_for;
+
+
+    PPL_FUNC_DECL void _call_projection(ppl::vertex<P_TYPE, DIM> const * const p, 
+                ppl::projection<P_TYPE, DIM> * const point_projection) const
     {
 
         ppl_assert__(poly_num>0, 
             "closest point was called on empty data! did you forget to load your data?\n");
 
-        point_projection->closest = splines[0][0];
+        // the scan is built for each instruction set, see ppl_dispatch.hpp
+        ppl::dispatch([&]{ 
+            if(lazy)
+                __lazy_scan(p, point_projection);
+            else
+                __scan(p, point_projection); 
+        });
+    }
+
+    static uint64_t __tiles(const uint64_t& _curves){ return (_curves + LAZY_TILE-1)/LAZY_TILE; }
+
+    // makes the coefficients of the tile 't' available, computing them if no query did yet
+    PPL_FUNC_DECL void __touch(const uint64_t& t) const
+    {
+        std::atomic<uint8_t>& state = tiles[t].state;
+        if(state.load(std::memory_order_acquire) == tile_ready)
+            return;
+
+        uint8_t expected{tile_bounded};
+        if(state.compare_exchange_strong(expected, tile_busy, std::memory_order_acquire)){
+            const uint64_t _first{t*LAZY_TILE}, _last{std::min(_first+LAZY_TILE, poly_num)};
+            std::uninitialized_default_construct_n(polys+_first, _last-_first);
+            std::uninitialized_default_construct_n(parametric+_first, _last-_first);
+            std::uninitialized_default_construct_n(deriv+_first, _last-_first);
+            for(uint64_t i{_first}; i < _last; ++i)
+                extract_coeffs(control_points+i*ppl::cubic, parametric[i], deriv[i], polys[i]);
+            state.store(tile_ready, std::memory_order_release);
+            return;
+        }
+
+        while(state.load(std::memory_order_acquire) != tile_ready)
+            std::this_thread::yield();
+    }
+
+    // the sphere holding the control points of the tile 't' of a path of '_curves' curves
+    void __bound(const uint64_t& t, const uint64_t& _curves)
+    {
+        const ppl::vertex<P_TYPE, DIM>* const _first{control_points + t*LAZY_TILE*ppl::cubic};
+        const ppl::vertex<P_TYPE, DIM>* const _last{control_points 
+                    + std::min((t+1)*LAZY_TILE, _curves)*ppl::cubic + 1};
+
+        ppl::vertex<P_TYPE, DIM> low{*_first}, high{*_first};
+        for(const ppl::vertex<P_TYPE, DIM>* q{_first}; q != _last; ++q){
+            low = ppl::fuse([](auto l, auto c){ return std::min(l, c); }, low, *q);
+            high = ppl::fuse([](auto h, auto c){ return std::max(h, c); }, high, *q);
+        }
+
+        tiles[t].centre = (low + high)/2;
+        P_TYPE radius{0};
+        for(const ppl::vertex<P_TYPE, DIM>* q{_first}; q != _last; ++q)
+            radius = std::max(radius, q->sqr_dist(tiles[t].centre));
+        tiles[t].radius = std::sqrt(radius);
+        tiles[t].state.store(tile_bounded, std::memory_order_relaxed);
+    }
+
+    // bounds again the tiles of the curves in [_first, _last), their coefficients are dropped
+    void __rebound(const uint64_t& _first, const uint64_t& _last, const uint64_t& _curves)
+    {
+        for(uint64_t t{_first/LAZY_TILE}; t < __tiles(_last); ++t)
+            __bound(t, _curves);
+    }
+
+    /*
+     * Same as __scan, but the tiles whose sphere is farther than the best
+     * distance found so far are skipped without their coefficients. The best
+     * distance starts from the end points of the nearest tile, so that most
+     * of the path is ruled out from the first query on.
+     */
+    PPL_FUNC_DECL void __lazy_scan(ppl::vertex<P_TYPE, DIM> const * const p, 
+                ppl::projection<P_TYPE, DIM> * const point_projection) const
+    {
+        point_projection->closest = control_points[0];
+		point_projection->index = 0;
+		point_projection->parameter = 0;
+        P_TYPE min_dist{(*p).sqr_dist( control_points[0] )}, curr_dist;
+
+        const uint64_t tile_num{__tiles(poly_num)};
+        uint64_t t{0}, i{0}, nearest{0};
+        P_TYPE gap, min_gap{std::numeric_limits<P_TYPE>::max()};
+        for(; t < tile_num; ++t){
+            gap = (*p).dist(tiles[t].centre) - tiles[t].radius;
+            if(gap < min_gap){
+                min_gap = gap;
+                nearest = t;
+            }
+        }
+
+        for(i = nearest*LAZY_TILE; i < std::min((nearest+1)*LAZY_TILE, poly_num); ++i){
+            curr_dist = (*p).sqr_dist(control_points[i*ppl::cubic + ppl::cubic]);
+            if (min_dist > curr_dist){
+                point_projection->closest = control_points[i*ppl::cubic + ppl::cubic];
+                point_projection->index = i;
+                point_projection->parameter = static_cast<P_TYPE>(1);
+                min_dist = curr_dist;
+            }
+        }
+
+        ppl::solver_scratch<P_TYPE, ALTERS_PRECISION> scratch;
+        for(t = 0; t < tile_num; ++t)
+        {
+            gap = (*p).dist(tiles[t].centre) - tiles[t].radius;
+            if(gap > 0 && gap*gap >= min_dist)
+                continue;
+
+            __touch(t);
+            for(i = t*LAZY_TILE; i < std::min((t+1)*LAZY_TILE, poly_num); ++i)
+            {
+                curr_dist = (*p).sqr_dist(control_points[i*ppl::cubic + ppl::cubic]);
+                if (min_dist > curr_dist){
+                    point_projection->closest = control_points[i*ppl::cubic + ppl::cubic];
+                    point_projection->index = i;
+                    point_projection->parameter = static_cast<P_TYPE>(1);
+                    min_dist = curr_dist;
+                }
+
+                if(project_on_curve(parametric[i], deriv[i], polys[i], *p, 
+                                min_dist, point_projection->parameter, scratch))
+                    point_projection->index = i;
+            }
+        }
+    }
+
+    PPL_FUNC_DECL void __scan(ppl::vertex<P_TYPE, DIM> const * const p, 
+                ppl::projection<P_TYPE, DIM> * const point_projection) const
+    {
+        point_projection->closest = control_points[0];
 		point_projection->index = 0;
 		point_projection->parameter = 0;
-        P_TYPE min_dist{(*p).sqr_dist( splines[0][0] )}, curr_dist;
+        P_TYPE min_dist{(*p).sqr_dist( control_points[0] )}, curr_dist;
+
+        // in registers when the path is lean
+        ppl::poly3d<P_TYPE, DIM> _parametric;
+        ppl::deriv3d<P_TYPE, DIM> _deriv;
+        ppl::poly1d<P_TYPE> _poly;
+        ppl::solver_scratch<P_TYPE, ALTERS_PRECISION> scratch;
     
         for (std::size_t i{0}; i < poly_num; ++i)
         {
 
-            curr_dist = (*p).sqr_dist(splines[i][ppl::cubic]);
+            curr_dist = (*p).sqr_dist(control_points[i*ppl::cubic + ppl::cubic]);
             if (min_dist > curr_dist){
-                point_projection->closest = splines[i][ppl::cubic];
+                point_projection->closest = control_points[i*ppl::cubic + ppl::cubic];
                 point_projection->index = i;
                 point_projection->parameter = static_cast<P_TYPE>(1);
                 min_dist = curr_dist;
             }
 
-            ppl::objPoly<ALTERS_PRECISION> obj_poly;
-            for(uint8_t j{1}; j<ppl::quintic_Coeffs; ++j)
-                if(j<ppl::cubic)
-                    obj_poly.poly.coeffs[j] = polys[i].coeffs[j];
-                else
-                    obj_poly.poly.coeffs[j] = polys[i].coeffs[j] 
-                    + (deriv[i].coeffs[j-ppl::cubic].dot(*p) / polys[i].coeffs[0]);
-
-            uint8_t _rN{num_alters_at(obj_poly.poly.coeffs, 0.0, 1.0)};
-
-            if (_rN != 0){
-                ppl::real_roots<P_TYPE> roots;
-                ppl::default_precision_polys<P_TYPE, ALTERS_PRECISION> __polys(obj_poly.poly.coeffs);
-
-                __split(obj_poly.poly.coeffs, __polys, 0.0, 1.0, _rN, roots, 1);
-
-                for (std::size_t j{0}; j < roots.num; ++j){
-                    curr_dist = (*p).sqr_dist(poly3d_solve_for(parametric[i], 
-                                                roots.zeros[j]));
-                    if (min_dist > curr_dist){
-                        point_projection->index = i;
-                        point_projection->parameter = roots.zeros[j];
-						min_dist = curr_dist;
-                    }
-                }
-            }  
+            if(lean){
+                recompute_coeffs(control_points + i*ppl::cubic, _parametric, _deriv, _poly);
+                if(project_on_curve(_parametric, _deriv, _poly, *p, 
+                                min_dist, point_projection->parameter, scratch))
+                    point_projection->index = i;
+            }
+            else if(project_on_curve(parametric[i], deriv[i], polys[i], *p, 
+                            min_dist, point_projection->parameter, scratch))
+                point_projection->index = i;
 
         }
     }
 
+    // the closest point, distance and tangent of a projection found by _call_projection
+    PPL_FUNC_DECL void __resolve(ppl::vertex<P_TYPE, DIM> const * const p, 
+                ppl::projection<P_TYPE, DIM> * const point_projection) const
+    {
+        ppl::poly3d<P_TYPE, DIM> _parametric;
+        ppl::deriv3d<P_TYPE, DIM> _deriv;
+        ppl::poly1d<P_TYPE> _poly;
+        if(lean)
+            recompute_coeffs(control_points + point_projection->index*ppl::cubic, 
+                            _parametric, _deriv, _poly);
+        else if(lazy)   // the end point a lazy scan starts from may be in a skipped tile
+            __touch(point_projection->index/LAZY_TILE);
+
+        const ppl::poly3d<P_TYPE, DIM>& __parametric = lean? _parametric : parametric[point_projection->index];
+        const ppl::deriv3d<P_TYPE, DIM>& __deriv = lean? _deriv : deriv[point_projection->index];
+
+        if(point_projection->parameter != static_cast<P_TYPE>(1) && point_projection->parameter != 0)
+            point_projection->closest = poly3d_solve_for(__parametric, point_projection->parameter);
+
+        point_projection->dist = point_projection->closest.dist(*p);
+        point_projection->tan = deriv3d_solve_for(__deriv, point_projection->parameter);
+    }
+
 
     void cleanUp(void)
     {
-        __freem( splines);
-        __freem( control_points);
-        __freem( polys);
-        __freem( parametric);
-        __freem( deriv);
+        if(viewed)
+            control_points = nullptr, polys = nullptr, parametric = nullptr, deriv = nullptr;
+        if(borrowed)
+            control_points = nullptr;
+        else
+            __freem( control_points, poly_cap*ppl::cubic+1);
+        __freem( polys, poly_cap);
+        __freem( parametric, poly_cap);
+        __freem( deriv, poly_cap);
+        if(lazy)
+            __freem( tiles, __tiles(poly_cap));
+        borrowed = lean = lazy = viewed = 0;
+
+        poly_num = points_num = poly_cap = 0;
+
+    }
+
+    // the memory of a lazy path is only touched for the tiles in use
+    template< typename T > 
+    PPL_FUNC_DECL T* __allocate_raw(const uint64_t& _num){
+        return static_cast<T*>(_resource->allocate(sizeof(T)*_num, 
+                            std::max<std::size_t>(alignof(T), ppl::alloc_alignment)));
+    }
+
+    template< typename T > 
+    PPL_FUNC_DECL T* __allocate(const uint64_t& _num){
+        T* _alloc = __allocate_raw<T>(_num);
+        std::uninitialized_default_construct_n(_alloc, _num);
+        return _alloc;
+    }
 
-        poly_num = points_num = 0;
+    void __allocate_lazy(void){
+        polys = __allocate_raw<ppl::poly1d<P_TYPE>>(poly_cap);
+        parametric = __allocate_raw<ppl::poly3d<P_TYPE, DIM>>(poly_cap);
+        deriv = __allocate_raw<ppl::deriv3d<P_TYPE, DIM>>(poly_cap);
+        tiles = __allocate<_lazy_tile>(__tiles(poly_cap));
+    }
 
+    // copies the bounds of the tiles of a lazy path, and the coefficients of those which are ready
+    void __copy_lazy(const ppl::poly1d<P_TYPE>* const _polys, 
+                const ppl::poly3d<P_TYPE, DIM>* const _parametric, 
+                const ppl::deriv3d<P_TYPE, DIM>* const _deriv, 
+                const _lazy_tile* const _tiles)
+    {
+        for(uint64_t t{0}; t < __tiles(poly_num); ++t){
+            tiles[t].centre = _tiles[t].centre;
+            tiles[t].radius = _tiles[t].radius;
+            if(_tiles[t].state.load(std::memory_order_acquire) != tile_ready){
+                tiles[t].state.store(tile_bounded, std::memory_order_relaxed);
+                continue;
+            }
+
+            const uint64_t _first{t*LAZY_TILE}, _num{std::min(_first+LAZY_TILE, poly_num)-_first};
+            memcpy(polys+_first, _polys+_first, sizeof(*polys)*_num);
+            memcpy(parametric+_first, _parametric+_first, sizeof(*parametric)*_num);
+            memcpy(deriv+_first, _deriv+_first, sizeof(*deriv)*_num);
+            tiles[t].state.store(tile_ready, std::memory_order_relaxed);
+        }
     }
 
     template< typename T > 
-    PPL_FUNC_DECL void __freem(T* &_alloc){
+    PPL_FUNC_DECL void __freem(T* &_alloc, const uint64_t& _num){
+        static_assert(std::is_trivially_destructible<T>::value, 
+            "the arrays of a path are released without destruction!");
         if(_alloc != nullptr){
-            delete[] _alloc;
+            _resource->deallocate(_alloc, sizeof(T)*_num, 
+                            std::max<std::size_t>(alignof(T), ppl::alloc_alignment));
             _alloc = nullptr;
         }
     }
 
+    template< typename T > 
+    PPL_FUNC_DECL void __regrow(T* &_alloc, const uint64_t& _used, 
+                const uint64_t& _cap, const uint64_t& _new_cap){
+        T* __alloc = __allocate<T>(_new_cap);
+        if(_alloc != nullptr)
+            memcpy(__alloc, _alloc, sizeof(T)*_used);
+        __freem(_alloc, _cap);
+        _alloc = __alloc;
+    }
+
+    // takes over the buffers of 'other', leaving it empty
+    void __steal(cubic_path& other) noexcept
+    {
+        _resource = other._resource;
+        control_points = other.control_points;
+        polys = other.polys;
+        parametric = other.parametric;
+        deriv = other.deriv;
+        tiles = other.tiles;
+        borrowed = other.borrowed;
+        lean = other.lean;
+        lazy = other.lazy;
+        viewed = other.viewed;
+        poly_num = other.poly_num;
+        points_num = other.points_num;
+        poly_cap = other.poly_cap;
+
+        other.control_points = nullptr;
+        other.polys = nullptr;
+        other.parametric = nullptr;
+        other.deriv = nullptr;
+        other.tiles = nullptr;
+        other.borrowed = other.lean = other.lazy = other.viewed = 0;
+        other.poly_num = other.points_num = other.poly_cap = 0;
+    }
+
+    // takes a private copy of borrowed control points before they get edited
+    void __own(void){
+        if(viewed){
+            cubic_path _private(*this);
+            cleanUp();
+            __steal(_private);
+        }
+        if(!borrowed)
+            return;
+
+        ppl::vertex<P_TYPE, DIM>* __points = __allocate<ppl::vertex<P_TYPE, DIM>>(poly_cap*ppl::cubic+1);
+        memcpy(__points, control_points, sizeof(ppl::vertex<P_TYPE, DIM>)*points_num);
+        control_points = __points;
+        borrowed = 0;
+    }
+
+    // grows the storage geometrically, so that appending curves is amortized O(appended)
+    void __reserve(const uint64_t& _curves){
+        if(_curves <= poly_cap)
+            return;
+
+        uint64_t cap{std::max<uint64_t>(_curves, poly_cap*2)};
+        __regrow(control_points, points_num, poly_cap*ppl::cubic+1, cap*ppl::cubic+1);
+        if(lazy){
+            ppl::poly1d<P_TYPE>* _polys{polys};
+            ppl::poly3d<P_TYPE, DIM>* _parametric{parametric};
+            ppl::deriv3d<P_TYPE, DIM>* _deriv{deriv};
+            _lazy_tile* _tiles{tiles};
+            const uint64_t _cap{poly_cap};
+
+            poly_cap = cap;
+            __allocate_lazy();
+            __copy_lazy(_polys, _parametric, _deriv, _tiles);
+            __freem(_polys, _cap);
+            __freem(_parametric, _cap);
+            __freem(_deriv, _cap);
+            __freem(_tiles, __tiles(_cap));
+            return;
+        }
+        if(!lean){
+            __regrow(polys, poly_num, poly_cap, cap);
+            __regrow(parametric, poly_num, poly_cap, cap);
+            __regrow(deriv, poly_num, poly_cap, cap);
+        }
+        poly_cap = cap;
+    }
+
+    // shifts the curves starting at '_from' by '_shift' curves, without recomputing them
+    void __shift(const uint64_t& _from, const int64_t& _shift){
+        uint64_t tail{poly_num-_from};
+        memmove(control_points+(_from+_shift)*ppl::cubic, control_points+_from*ppl::cubic, 
+                sizeof(ppl::vertex<P_TYPE, DIM>)*(tail*ppl::cubic+1));
+        if(lazy)   // the tiles don't hold the same curves anymore
+            __rebound(std::min<uint64_t>(_from, _from+_shift), poly_num+_shift, poly_num+_shift);
+        if(lean || lazy)
+            return;
+        memmove(polys+_from+_shift, polys+_from, sizeof(*polys)*tail);
+        memmove(parametric+_from+_shift, parametric+_from, sizeof(*parametric)*tail);
+        memmove(deriv+_from+_shift, deriv+_from, sizeof(*deriv)*tail);
+    }
+
+    void __extract(uint64_t _first, const uint64_t& _last){
+        ppl::dispatch([&]{
+            for(; _first < _last; ++_first)
+                extract_coeffs(control_points+_first*ppl::cubic, 
+                        parametric[_first], deriv[_first], polys[_first]);
+        });
+    }
+
+#ifdef PPL_CONCURRENCY
+
+    // curves under which a thread is not worth starting
+    static constexpr uint64_t REFRESH_GRAIN{1<<14};
+
+    static void* __extract_task(void* argv){
+
+        cubic_path* path = (cubic_path*) ((void**)argv)[0];
+        const uint64_t* const range = (const uint64_t*) ((void**)argv)[1];
+
+        path->__extract(range[0], range[1]);
+
+        pthread_exit(nullptr);
+        return nullptr;
+    }
+
+#endif
+
+    /*
+     * Recomputes the curves in [_first, _last), and only those. With
+     * PPL_CONCURRENCY a long range is split across the processors, each
+     * curve is independent of the others. A lazy path leaves them to the
+     * queries.
+     */
+    void __refresh(const uint64_t& _first, const uint64_t& _last){
+        if(lean || _first >= _last)
+            return;
+        if(lazy)
+            return __rebound(_first, _last, poly_num);
+
+#ifdef PPL_CONCURRENCY
+        const uint64_t _thrN{std::min<uint64_t>(ppl::processors(), 
+                                (_last-_first)/REFRESH_GRAIN)};
+        if(_thrN > 1){
+            std::vector<uint64_t> bounds(_thrN+1);
+            for(uint64_t i{0}; i <= _thrN; ++i)
+                bounds[i] = _first + (_last-_first)*i/_thrN;
+
+            std::vector<std::unique_ptr<ppl::_channel>> thrd(_thrN);
+            for(uint64_t i{1}; i < _thrN; ++i)
+                thrd[i] = std::make_unique<ppl::_channel>(__extract_task, 2, 
+                            (void*)this, (void*)&bounds[i]);
+
+            __extract(bounds[0], bounds[1]);
+
+            for(uint64_t i{1}; i < _thrN; ++i)
+                thrd[i]->join(nullptr);
+            return;
+        }
+#endif
+
+        __extract(_first, _last);
+    }
+
+    void __routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, bool _borrow, bool _lean, bool _lazy = 0)
+    {      
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        if(points_num != 0)  cleanUp();
+
+        points_num = _size;
+        poly_cap = poly_num = (_size-1)/ppl::cubic; 
+        borrowed = _borrow;
+        lean = _lean;
+        lazy = _lazy;
+
+        if(borrowed)
+            control_points = const_cast<ppl::vertex<P_TYPE, DIM>*>(points);
+        else{
+            control_points = __allocate<ppl::vertex<P_TYPE, DIM>>(_size);
+            memcpy(control_points, points, sizeof(ppl::vertex<P_TYPE, DIM>)*_size); 
+        }
+
+        if(lazy)
+            __allocate_lazy();
+        else if(!lean){
+            polys = __allocate<ppl::poly1d<P_TYPE>>(poly_num);
+            parametric = __allocate<ppl::poly3d<P_TYPE, DIM>>(poly_num);
+            deriv = __allocate<ppl::deriv3d<P_TYPE, DIM>>(poly_num);
+        }
+
+        __refresh(0, poly_num);
+    }
+
 public:    
 
     cubic_path(): 
-            splines{nullptr}, control_points{nullptr},   
+            control_points{nullptr},   
             polys{nullptr}, parametric{nullptr}, 
             deriv{nullptr},
-            poly_num{0}, points_num{0}, min_depth{ppl::quintic}
+            poly_num{0}, points_num{0}, poly_cap{0}
     {
         ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
             "instantiation of ppl::cubic_path can only be with floating-point types!\n");
     }
 
-    cubic_path(const ppl::vertex<P_TYPE>* const points,
-            const uint64_t& _size): min_depth{ppl::quintic} {
+    /*
+     * All the arrays of the path are allocated from '__resource', which has
+     * to outlive the path. See ppl::track_arena for a resource backed by
+     * huge pages.
+     */
+    explicit cubic_path(std::pmr::memory_resource* __resource): cubic_path() {
+        ppl_assert__(__resource != nullptr, "invalid memory resource!");
+        _resource = __resource;
+    }
+
+    cubic_path(const ppl::vertex<P_TYPE, DIM>* const points,
+            const uint64_t& _size): cubic_path() {
         ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
             "instantiation of ppl::cubic_path can only be with floating-point types!\n");
         routing(points, _size);
     }
        
+    cubic_path(const ppl::vertex<P_TYPE, DIM>* const points,
+            const uint64_t& _size, ppl::borrow_points_t): cubic_path() {
+        ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
+            "instantiation of ppl::cubic_path can only be with floating-point types!\n");
+        routing(points, _size, ppl::borrow_points);
+    }
+       
+    /*
+     * Copies are deep, except for borrowed control points which stay borrowed
+     * by the copy. The copy of a view owns all its arrays. A copy is allocated from the same memory resource as the
+     * original, while assigning to a path keeps the path's own resource.
+     * Moving a path only hands over its buffers, unless it's assigned to a
+     * path using another resource.
+     */
+    cubic_path(const cubic_path& other): cubic_path(other._resource) { *this = other; }
+
+    cubic_path(cubic_path&& other) noexcept: cubic_path() { __steal(other); }
+
+    cubic_path& operator=(const cubic_path& other)
+    {
+        if(this == &other)
+            return *this;
+
+        cleanUp();
+        if(other.poly_num == 0)
+            return *this;
+
+        points_num = other.points_num;
+        poly_cap = poly_num = other.poly_num;
+        borrowed = other.borrowed && !other.viewed;
+        lean = other.lean;
+        lazy = other.lazy;
+
+        if(borrowed)
+            control_points = other.control_points;
+        else{
+            control_points = __allocate<ppl::vertex<P_TYPE, DIM>>(points_num);
+            memcpy(control_points, other.control_points, sizeof(ppl::vertex<P_TYPE, DIM>)*points_num);
+        }
+
+        if(lean)
+            return *this;
+
+        if(lazy){
+            __allocate_lazy();
+            __copy_lazy(other.polys, other.parametric, other.deriv, other.tiles);
+            return *this;
+        }
+
+        polys = __allocate<ppl::poly1d<P_TYPE>>(poly_num);
+        parametric = __allocate<ppl::poly3d<P_TYPE, DIM>>(poly_num);
+        deriv = __allocate<ppl::deriv3d<P_TYPE, DIM>>(poly_num);
+        memcpy(polys, other.polys, sizeof(ppl::poly1d<P_TYPE>)*poly_num);
+        memcpy(parametric, other.parametric, sizeof(ppl::poly3d<P_TYPE, DIM>)*poly_num);
+        memcpy(deriv, other.deriv, sizeof(ppl::deriv3d<P_TYPE, DIM>)*poly_num);
+
+        return *this;
+    }
+
+    cubic_path& operator=(cubic_path&& other)
+    {
+        if(this == &other)
+            return *this;
+
+        if(_resource->is_equal(*other._resource)){
+            cleanUp();
+            __steal(other);
+        }
+        else
+            *this = static_cast<const cubic_path&>(other);
+        return *this;
+    }
+
+    std::pmr::memory_resource* resource(void) const { return _resource; }
+       
     virtual ~cubic_path() { cleanUp(); }
 
 
 #ifdef PPL_CONCURRENCY
 
-    void closest_point(ppl::vertex<P_TYPE> const * const p, 
-            ppl::projection<P_TYPE> * const projection_ptr) const
+    void closest_point(ppl::vertex<P_TYPE, DIM> const * const p, 
+            ppl::projection<P_TYPE, DIM> * const projection_ptr) const
     {
         _call_projection(p, projection_ptr);
-        if(projection_ptr->parameter != static_cast<P_TYPE>(1) && projection_ptr->parameter != 0){
-            projection_ptr->closest = poly3d_solve_for(parametric[projection_ptr->index], 
-                                                    projection_ptr->parameter);
-        }
-
-        projection_ptr->dist = projection_ptr->closest.dist(*p);
-        projection_ptr->tan = deriv3d_solve_for(deriv[projection_ptr->index], 
-                                        projection_ptr->parameter);
+        __resolve(p, projection_ptr);
     }
 
 #endif
 
-    void routing(const ppl::vertex<P_TYPE>* const points, 
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
                     const uint64_t& _size)
     {      
-        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
-                    "incompatible number of control points!");
+        __routing(points, _size, 0, 0);
+    }
+
+    /*
+     * Same as routing(points, _size), but the control points are referenced
+     * instead of being copied, so only the derived coefficients are kept by
+     * the path. The caller has to keep the control points alive and unchanged
+     * for as long as the path uses them. Editing the path takes a private
+     * copy of them first.
+     */
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::borrow_points_t)
+    {      
+        __routing(points, _size, 1, 0);
+    }
+
+    /*
+     * Same as routing(points, _size), but only the control points are kept.
+     * The coefficients of every curve are recomputed by each query, which
+     * trades arithmetic for memory bandwidth on paths too large for the
+     * caches. Edits keep the path lean.
+     */
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::lean_coeffs_t)
+    {      
+        __routing(points, _size, 0, 1);
+    }
+
+    // a lean path of borrowed control points, the path holds no memory per curve
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::borrow_points_t, ppl::lean_coeffs_t)
+    {      
+        __routing(points, _size, 1, 1);
+    }
+
+    /*
+     * Same as routing(points, _size), but the coefficients of a tile of
+     * curves are computed by the first query reaching it, and kept. Loading
+     * only bounds the tiles, so a large map is ready at once and pays for
+     * the area actually queried. Queries may run concurrently, edits may not.
+     */
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::lazy_coeffs_t)
+    {      
+        __routing(points, _size, 0, 0, 1);
+    }
+
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size, ppl::borrow_points_t, ppl::lazy_coeffs_t)
+    {      
+        __routing(points, _size, 1, 0, 1);
+    }
+
+    bool borrows_points(void) const { return borrowed; }
+
+    bool is_lean(void) const { return lean; }
+
+    bool is_lazy(void) const { return lazy; }
+
+    bool is_view(void) const { return viewed; }
+
+    // the arrays of a path, with the number of curves they hold
+    struct arrays{
+        const ppl::vertex<P_TYPE, DIM>* points{nullptr};
+        const ppl::poly1d<P_TYPE>* polys{nullptr};
+        const ppl::poly3d<P_TYPE, DIM>* parametric{nullptr};
+        const ppl::deriv3d<P_TYPE, DIM>* deriv{nullptr};
+        uint64_t curves{0};
+    };
+
+    // the arrays of a path whose coefficients are all computed
+    arrays data(void) const {
+        ppl_assert__(!lean && !lazy, "the path has no coefficients to expose!");
+        return arrays{control_points, polys, parametric, deriv, poly_num};
+    }
+
+    /*
+     * Makes the path a view of arrays laid out by data(), which the caller
+     * keeps alive and unchanged for as long as the path uses them. Nothing is
+     * computed nor copied, so that a path built elsewhere "a file or a shared
+     * memory segment" is queried at once. Editing the view, or copying it,
+     * takes private copies of the arrays first.
+     */
+    void view(const arrays& _arrays){
+        ppl_assert__(_arrays.curves > 0 && _arrays.points != nullptr && _arrays.polys != nullptr 
+                && _arrays.parametric != nullptr && _arrays.deriv != nullptr, "viewing an empty path!");
         call_significant_fig_ascertain();
+        cleanUp();
+        control_points = const_cast<ppl::vertex<P_TYPE, DIM>*>(_arrays.points);
+        polys = const_cast<ppl::poly1d<P_TYPE>*>(_arrays.polys);
+        parametric = const_cast<ppl::poly3d<P_TYPE, DIM>*>(_arrays.parametric);
+        deriv = const_cast<ppl::deriv3d<P_TYPE, DIM>*>(_arrays.deriv);
+        poly_cap = poly_num = _arrays.curves;
+        points_num = poly_num*ppl::cubic + 1;
+        borrowed = viewed = 1;
+    }
 
-        if(points_num != 0)  cleanUp();
+    // the curves whose coefficients a lazy path has computed so far
+    uint64_t computed_curves(void) const {
+        if(!lazy)
+            return lean? 0 : poly_num;
+        uint64_t _computed{0};
+        for(uint64_t t{0}; t < __tiles(poly_num); ++t)
+            if(tiles[t].state.load(std::memory_order_acquire) == tile_ready)
+                _computed += std::min((t+1)*LAZY_TILE, poly_num) - t*LAZY_TILE;
+        return _computed;
+    }
 
-        points_num = _size;
-        poly_num = (_size-1)/ppl::cubic; 
+    // bytes held by the path per curve, control points included unless they are borrowed
+    static constexpr std::size_t bytes_per_curve(bool _borrowed = 0, bool _lean = 0) {
+        return (_borrowed? 0 : sizeof(ppl::vertex<P_TYPE, DIM>)*ppl::cubic)
+            + (_lean? 0 : sizeof(ppl::poly1d<P_TYPE>) + sizeof(ppl::poly3d<P_TYPE, DIM>) 
+                        + sizeof(ppl::deriv3d<P_TYPE, DIM>));
+    }
 
-        
-        control_points = new ppl::vertex<P_TYPE>[_size];
-        memcpy(control_points, points, sizeof(ppl::vertex<P_TYPE>)*_size); 
+    // bytes currently allocated by the path, including spare capacity
+    std::size_t footprint(void) const {
+        if(poly_cap == 0 || viewed)
+            return 0;
+        return bytes_per_curve(borrowed, lean)*poly_cap 
+            + (borrowed? 0 : sizeof(ppl::vertex<P_TYPE, DIM>))
+            + (lazy? sizeof(_lazy_tile)*__tiles(poly_cap) : 0);
+    }
 
-        splines = new ppl::vertex<P_TYPE>[poly_num] [ppl::cubic_points];
-        
-        std::size_t term = points_num-ppl::cubic;
-        uint64_t i{0}, j{0};
-        for(i=0, j=0; i < term; ++j, i+=ppl::cubic){
-            memcpy(splines[j], points+i, 
-                sizeof(ppl::vertex<P_TYPE>)*ppl::cubic_points);
+    uint64_t curves(void) const { return poly_num; }
+
+    /*
+     * Editing the path in place. Only the curves whose control points are
+     * changed get recomputed; curves behind an edit are just shifted. 
+     * Curve indices refer to the state of the path before the edit.
+     */
+
+    // appends curves continuing from the last control point, 3 control points per curve
+    void append(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& _size)
+    {
+        ppl_assert__(poly_num>0, "appending to an empty path! use routing() instead\n");
+        ppl_assert__(_size%ppl::cubic == 0 && _size > 0, 
+                    "incompatible number of control points!");
+        __own();
+
+        uint64_t _first{poly_num};
+        __reserve(poly_num + _size/ppl::cubic);
+        memcpy(control_points+points_num, _points, sizeof(ppl::vertex<P_TYPE, DIM>)*_size);
+
+        points_num += _size;
+        poly_num += _size/ppl::cubic;
+        __refresh(_first, poly_num);
+    }
+
+    /*
+     * Removes '_count' curves starting at the curve '_first'. If the removed
+     * curves are in the middle of the path, the first control point of the
+     * following curve is moved onto the last control point of the preceding
+     * one, so that the path stays connected.
+     */
+    void erase(const uint64_t& _first, const uint64_t& _count)
+    {
+        ppl_assert__(_count > 0 && _first + _count <= poly_num, 
+                    "curves to erase are out of range!");
+        ppl_assert__(_count < poly_num, "erasing all curves of the path!");
+        __own();
+
+        if(_first + _count < poly_num){
+            ppl::vertex<P_TYPE, DIM> junction{control_points[_first*ppl::cubic]};
+            __shift(_first+_count, -static_cast<int64_t>(_count));
+            if(_first > 0){
+                control_points[_first*ppl::cubic] = junction;
+                __refresh(_first, _first+1);
+            }
         }
 
-        polys = new ppl::poly1d<P_TYPE>[poly_num];
+        points_num -= _count*ppl::cubic;
+        poly_num -= _count;
+    }
 
-        parametric = new ppl::poly3d<P_TYPE>[poly_num];
-        deriv = new ppl::deriv3d<P_TYPE>[poly_num];
+    /*
+     * Replaces '_count' curves starting at the curve '_first' by the subpath
+     * given with '_size' control points "_size = 3k+1 for k curves". The ends
+     * of the subpath become the junctions with the neighbouring curves, which
+     * are recomputed as well. '_count' may be 0 to insert a subpath.
+     */
+    void splice(const uint64_t& _first, const uint64_t& _count,
+                ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& _size)
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        ppl_assert__(_first + _count <= poly_num, "curves to splice are out of range!");
+        __own();
 
-        for(i=0, j=0; i < term; ++j, i+=ppl::cubic)
-            extract_poly(j, points+i);
+        uint64_t _new{(_size-1)/ppl::cubic};
+        __reserve(poly_num - _count + _new);
+        if(_new != _count && _first + _count < poly_num)
+            __shift(_first+_count, static_cast<int64_t>(_new) - static_cast<int64_t>(_count));
 
+        memcpy(control_points+_first*ppl::cubic, _points, sizeof(ppl::vertex<P_TYPE, DIM>)*_size);
+        points_num += (_new - _count)*ppl::cubic;
+        poly_num += _new - _count;
+
+        __refresh(_first > 0? _first-1 : 0, 
+                std::min(_first+_new+1, poly_num));
     }
 
-    ppl::projection<P_TYPE> 
-    closest_point(ppl::vertex<P_TYPE> const * const p) const
+    // moves a single control point, recomputing the one or two curves sharing it
+    void move_control_point(const uint64_t& _ind, const ppl::vertex<P_TYPE, DIM>& _point)
+    {
+        ppl_assert__(_ind < points_num, "control point is out of range!");
+        __own();
+
+        control_points[_ind] = _point;
+        uint64_t _curve{_ind/ppl::cubic};
+        if(_ind%ppl::cubic == 0)
+            __refresh(_curve > 0? _curve-1 : 0, std::min(_curve+1, poly_num));
+        else
+            __refresh(_curve, _curve+1);
+    }
+
+    ppl::projection<P_TYPE, DIM> 
+    closest_point(ppl::vertex<P_TYPE, DIM> const * const p) const
 
     {
-        ppl::projection<P_TYPE> point_projection;
+        ppl::projection<P_TYPE, DIM> point_projection;
         _call_projection(p, &point_projection);
-        if(point_projection.parameter != static_cast<P_TYPE>(1) && point_projection.parameter != 0){
-            point_projection.closest = poly3d_solve_for(parametric[point_projection.index], 
-                                        point_projection.parameter);
-        }
-
-        point_projection.dist = point_projection.closest.dist(*p);
-        point_projection.tan = deriv3d_solve_for(deriv[point_projection.index], 
-                                        point_projection.parameter);
+        __resolve(p, &point_projection);
         return point_projection;
     
     }
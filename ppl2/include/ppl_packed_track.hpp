@@ -0,0 +1,332 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_PACKED_TRACK_HPP
+#define PPL_PACKED_TRACK_HPP
+
+
+#include "ppl_skelets.hpp"
+
+#include <stdexcept>
+
+
+namespace ppl
+{
+
+/*
+ * A compressed path for storage and transfer. Every control point is
+ * quantized to a grid of the given resolution, e.g. 1e-3 for millimeters,
+ * relative to the first control point, and stored as the zigzag varint
+ * encoded difference to the previous point. The points are encoded in
+ * independent blocks, each one starting with an absolute point, so a range
+ * of curves can be decoded without decoding the whole path.
+ *
+ * Layout "little-endian, as written by the host":
+ *
+ *   _header
+ *   uint64_t  offsets[blocks]   // of each block from the end of the table
+ *   uint8_t   payload[]
+ *
+ * The largest distance between a control point and its decoded value is
+ * measured while encoding and kept in the header, it's never more than
+ * resolution*sqrt(3)/2.
+ */
+class packed_track
+{
+
+public:
+
+    static constexpr char magic[4]={'P', 'P', 'L', 'Q'};
+    static constexpr uint32_t version{1};
+
+private:
+
+    struct _header{
+        char magic[4];
+        uint32_t version;
+        uint64_t points;
+        uint32_t block_points;
+        uint32_t reserved;
+        double resolution;
+        double error_bound;
+        double origin[3];
+    };
+
+    _header header{};
+    std::vector<uint8_t> data;   // header, offsets and payload
+
+
+    static uint64_t zigzag(int64_t v) { 
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); 
+    }
+
+    static int64_t unzigzag(uint64_t v) { 
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); 
+    }
+
+    static void put_varint(std::vector<uint8_t>& out, uint64_t v){
+        while(v >= 0x80){
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    static uint64_t get_varint(const uint8_t*& in, const uint8_t* const end){
+        uint64_t v{0};
+        for(uint32_t shift{0}; shift < 64; shift += 7){
+            if(in == end)
+                throw std::out_of_range("truncated packed track!");
+            const uint8_t byte = *in++;
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if(!(byte & 0x80))
+                return v;
+        }
+        throw std::invalid_argument("corrupted packed track!");
+    }
+
+    uint64_t blocks(const uint64_t& _points) const {
+        return _points / header.block_points + (_points % header.block_points != 0);
+    }
+
+    uint64_t offset(const uint64_t& b) const {
+        uint64_t _offset;
+        memcpy(&_offset, data.data() + sizeof(_header) + sizeof(uint64_t)*b, sizeof(uint64_t));
+        return _offset;
+    }
+
+    const uint8_t* payload(void) const {
+        return data.data() + sizeof(_header) + sizeof(uint64_t)*blocks();
+    }
+
+    void validate(void)
+    {
+        if(data.size() < sizeof(_header))
+            throw std::invalid_argument("not a packed track, the data is too short!");
+        memcpy(&header, data.data(), sizeof(_header));
+
+        if(memcmp(header.magic, magic, sizeof(magic)) != 0)
+            throw std::invalid_argument("not a packed track, wrong magic number!");
+        if(header.version != version)
+            throw std::invalid_argument("unsupported version of packed track: " 
+                    + std::to_string(header.version));
+        if(header.block_points == 0 || !(header.resolution > 0) || !std::isfinite(header.resolution) 
+                || !std::isfinite(header.origin[0]) || !std::isfinite(header.origin[1]) 
+                || !std::isfinite(header.origin[2]) 
+                || (header.points - 1)%ppl::cubic != 0 || header.points <= ppl::cubic)
+            throw std::invalid_argument("corrupted packed track header!");
+        if(blocks() > (data.size() - sizeof(_header)) / sizeof(uint64_t))
+            throw std::out_of_range("truncated packed track!");
+
+        // each point takes a byte per coordinate at least
+        const uint64_t _payload = data.size() - sizeof(_header) - sizeof(uint64_t)*blocks();
+        if(header.points > _payload / 3)
+            throw std::out_of_range("truncated packed track!");
+        for(uint64_t b{0}; b < blocks(); ++b)
+            if(offset(b) >= _payload)
+                throw std::out_of_range("truncated packed track!");
+    }
+
+public:
+
+    packed_track() = default;
+
+    // takes a buffer produced by bytes() or read from a file
+    packed_track(const uint8_t* const _data, const std::size_t& _size):
+            data(_data, _data+_size) {
+        validate();
+    }
+
+    explicit packed_track(std::vector<uint8_t>&& _data): data(std::move(_data)) {
+        validate();
+    }
+
+
+    /*
+     * Encodes the control points of a path, 'block_points' control points
+     * per block. Smaller blocks make decoding a range cheaper at the cost of
+     * one absolute point per block.
+     */
+    template<typename P_TYPE>
+    static packed_track encode(const ppl::vertex<P_TYPE>* const points, 
+                const uint64_t& _size, const double& _resolution, 
+                const uint32_t& _block_points = 4096)
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        ppl_assert__(_resolution > 0 && _block_points > 0, 
+                    "invalid resolution or block size of packed track!");
+
+        packed_track track;
+        _header& h = track.header;
+        memcpy(h.magic, magic, sizeof(magic));
+        h.version = version;
+        h.points = _size;
+        h.block_points = _block_points;
+        h.resolution = _resolution;
+        for(uint32_t k{0}; k<3; ++k)
+            h.origin[k] = static_cast<double>(points[0][k]);
+
+        const uint64_t _blocks{track.blocks()};
+        std::vector<uint64_t> _offsets(_blocks);
+        std::vector<uint8_t> _payload;
+        _payload.reserve(_size * 3);
+
+        int64_t prev[3]={0, 0, 0};
+        for(uint64_t i{0}; i<_size; ++i)
+        {
+            if(i % _block_points == 0){
+                _offsets[i / _block_points] = _payload.size();
+                prev[0] = prev[1] = prev[2] = 0;
+            }
+
+            double sqr_err{0};
+            for(uint32_t k{0}; k<3; ++k){
+                const double q = std::round(
+                    (static_cast<double>(points[i][k]) - h.origin[k]) / _resolution);
+                ppl_assert__(std::fabs(q) < 4e18, 
+                    "the resolution of packed track is too fine for the extent of the path!");
+
+                const int64_t curr = static_cast<int64_t>(q);
+                put_varint(_payload, zigzag(curr - prev[k]));
+                prev[k] = curr;
+
+                const double err = h.origin[k] + q*_resolution - static_cast<double>(points[i][k]);
+                sqr_err += err*err;
+            }
+            h.error_bound = std::max(h.error_bound, std::sqrt(sqr_err));
+        }
+
+        track.data.resize(sizeof(_header) + sizeof(uint64_t)*_blocks + _payload.size());
+        memcpy(track.data.data(), &h, sizeof(_header));
+        memcpy(track.data.data() + sizeof(_header), _offsets.data(), 
+                sizeof(uint64_t)*_blocks);
+        memcpy(track.data.data() + sizeof(_header) + sizeof(uint64_t)*_blocks, 
+                _payload.data(), _payload.size());
+        return track;
+    }
+
+
+    /*
+     * Decodes the control points from 'first' to 'last' "exclusive" into
+     * 'out', only the blocks covering them are decoded.
+     */
+    template<typename P_TYPE>
+    void decode_points(const uint64_t& first, const uint64_t& last, 
+                ppl::vertex<P_TYPE>* const out) const
+    {
+        ppl_assert__(first <= last && last <= header.points, 
+                    "decoding out of the range of packed track!");
+
+        const uint8_t* const end = data.data() + data.size();
+        uint64_t i{first - first % header.block_points};
+
+        while(i < last)
+        {
+            const uint8_t* in = payload() + offset(i / header.block_points);
+            const uint64_t block_end = std::min<uint64_t>(
+                        i + header.block_points, header.points);
+
+            // summed modulo 2^64, so that crafted deltas can't overflow
+            uint64_t curr[3]={0, 0, 0};
+            for(; i < block_end && i < last; ++i)
+                for(uint32_t k{0}; k<3; ++k){
+                    curr[k] += static_cast<uint64_t>(unzigzag(get_varint(in, end)));
+                    if(i >= first)
+                        out[i-first][k] = static_cast<P_TYPE>(header.origin[k] 
+                            + static_cast<double>(static_cast<int64_t>(curr[k]))*header.resolution);
+                }
+            i = block_end;
+        }
+    }
+
+    // all the control points of the path
+    template<typename P_TYPE>
+    void decode(std::vector<ppl::vertex<P_TYPE>>& _points) const {
+        _points.resize(header.points);
+        decode_points(0, header.points, _points.data());
+    }
+
+    // the 3*count+1 control points of the curves [first, first+count)
+    template<typename P_TYPE>
+    void decode_curves(const uint64_t& first, const uint64_t& count, 
+                std::vector<ppl::vertex<P_TYPE>>& _points) const {
+        ppl_assert__(count > 0 && first + count <= curves(), 
+                    "decoding out of the range of packed track!");
+        _points.resize(count*ppl::cubic + 1);
+        decode_points(first*ppl::cubic, (first+count)*ppl::cubic + 1, _points.data());
+    }
+
+
+    uint64_t points(void) const { return header.points; }
+    uint64_t curves(void) const { return header.points ? (header.points-1)/ppl::cubic : 0; }
+    uint64_t blocks(void) const { return header.points ? blocks(header.points) : 0; }
+    double resolution(void) const { return header.resolution; }
+    double error_bound(void) const { return header.error_bound; }
+
+    // the encoded track, header included
+    const std::vector<uint8_t>& bytes(void) const { return data; }
+
+    static bool is_packed(const void* const _data, const std::size_t& _size){
+        return _size >= sizeof(magic) && memcmp(_data, magic, sizeof(magic)) == 0;
+    }
+
+
+    void save(const std::string& _dir) const {
+        std::ofstream file(_dir, std::ios::binary | std::ios::trunc);
+        if(!file)
+            throw std::runtime_error("could not open file <"+_dir+">\n");
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if(!file)
+            throw std::runtime_error("could not write file <"+_dir+">\n");
+    }
+
+    static packed_track load(const std::string& _dir) {
+        std::ifstream file(_dir, std::ios::binary);
+        if(!file)
+            throw std::runtime_error("could not open file <"+_dir+">\n");
+        std::vector<uint8_t> _data((std::istreambuf_iterator<char>(file)), 
+                                    std::istreambuf_iterator<char>());
+        return packed_track(std::move(_data));
+    }
+
+};
+
+} // namespace ppl
+
+#endif //  PPL_PACKED_TRACK_HPP
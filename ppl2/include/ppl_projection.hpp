@@ -53,14 +53,14 @@ namespace ppl{
 
 #ifdef PPL_CONCURRENCY
 
-template<typename  P_TYPE>  struct thrStr{
+template<typename  P_TYPE, std::size_t DIM>  struct thrStr{
 
     static void* _task(void* argv){
         
-        ppl::cubic_path<P_TYPE>* path = (ppl::cubic_path<P_TYPE>*) ((void**)argv)[0];
+        const ppl::cubic_path<P_TYPE, DIM>* path = (const ppl::cubic_path<P_TYPE, DIM>*) ((void**)argv)[0];
 
-        path->closest_point(  (ppl::vertex<P_TYPE> *) ((void**)argv)[1],
-                     (ppl::projection<P_TYPE> *) ((void**)argv)[2] );
+        path->closest_point(  (ppl::vertex<P_TYPE, DIM> *) ((void**)argv)[1],
+                     (ppl::projection<P_TYPE, DIM> *) ((void**)argv)[2] );
 
         pthread_exit(nullptr);
         return nullptr;
@@ -69,182 +69,235 @@ template<typename  P_TYPE>  struct thrStr{
 
 #endif
 
-template< typename P_TYPE> class point_projection
-
-{   
-	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
-		"instantiation of ppl::point_projection can only be with floating-point types!\n");
-
 #ifdef PPL_EXTERNAL_TRACK_LOADING
 
-    ppl::vertex<P_TYPE>* points{nullptr};
-    uint64_t _size{0};
-
-    void* addr{nullptr};
-    std::istringstream s_stream;
-    signed f_descriptor;
-    struct stat buf;
+PPL_FUNC_DECL uint64_t num_of_p(char *addr, const uint64_t& len){
 
+    std::stringstream s_stream;
+    s_stream.rdbuf()->pubsetbuf(addr, len);
+    return std::distance(std::istream_iterator<std::string>(s_stream), 
+            std::istream_iterator<std::string>());
+}
 
-#endif
-
-#ifdef PPL_CONCURRENCY
 
-    std::size_t _thrN{0};
-    std::vector<std::tuple<uint64_t, uint64_t>> jobs_intervals;
-    std::vector<ppl::projection<P_TYPE>> thr_verts;
+PPL_FUNC_DECL bool 
+does_exist(const fs::path& _dir, 
+        fs::file_status _status = fs::file_status{})
+{
+    return (fs::status_known(_status) ? fs::exists(_status) : fs::exists(_dir));
+}
 
-    ppl::cubic_path<P_TYPE>* _track_strips{nullptr};
+/*
+ * Reads the control points of a path from a text file, one point per row
+ * with DIM entries, e.g. "X, Y and Z", or from a file written by
+ * ppl::packed_track::save. The file is mapped into memory and parsed in
+ * place; the previous content of '_points' is replaced.
+ */
+template<typename P_TYPE, std::size_t DIM> 
+void load_control_points(const std::string& _dir, 
+            std::vector<ppl::vertex<P_TYPE, DIM>>& _points){
+#ifdef __linux__
 
-    uint64_t splinesN;
-    _channel** thrd{nullptr};
-    
-#else
+    if(!does_exist(_dir))
+        throw std::invalid_argument("cannot find file <"+_dir+">\n" );
 
-    ppl::cubic_path<P_TYPE> _track;
+    signed f_descriptor = open(_dir.c_str(), O_RDONLY, S_IRUSR|S_IWUSR);
     
-#endif
+    if( f_descriptor < 0)
+        throw std::runtime_error("could not open file <"+_dir+">\n");
 
-#ifdef PPL_CONCURRENCY
-    void build_intervals(const unsigned& tks_per_thr, 
-        const unsigned& __size)
-    {
-        jobs_intervals.clear();
-        std::tuple<std::size_t, std::size_t> tup;
+    struct stat buf;
+    if(fstat(f_descriptor,&buf) < 0){
+        close(f_descriptor);
+        throw std::runtime_error("not able to get file size <"+_dir+">\n");
+    }
 
-        std::get<0>(tup) = 0;
-        std::get<1>(tup) = (tks_per_thr * ppl::cubic) + 1;
-        jobs_intervals.push_back(tup);
+    void* addr = mmap(NULL, buf.st_size, 
+            PROT_READ, MAP_PRIVATE, f_descriptor, 0);
 
-        for (unsigned j{1}; j < _thrN; ++j){
+    if(addr == MAP_FAILED){
+        close(f_descriptor);
+        throw std::runtime_error("an exception occurred while mapping the file <"+_dir+">\n");
+    }
 
-            std::get<0>(tup) = std::get<0>(jobs_intervals[j-1])
-                    + std::get<1>(jobs_intervals[j-1]) - 1;
-            std::get<1>(tup) =  (tks_per_thr * ppl::cubic) + 1;
-            jobs_intervals.push_back(tup);
+    if(ppl::packed_track::is_packed(addr, buf.st_size)){
+        try{
+            if constexpr(DIM == 3)
+                ppl::packed_track(reinterpret_cast<const uint8_t*>(addr), 
+                                buf.st_size).decode(_points);
+            else
+                throw std::invalid_argument("packed tracks hold 3D control points!");
+        }catch(const std::exception& e){
+            munmap(addr, buf.st_size);
+            close(f_descriptor);
+            throw std::invalid_argument(std::string(e.what()) + " in the file <"+_dir+">\n");
         }
-
-        std::get<1>(jobs_intervals[jobs_intervals.size() - 1]) = __size 
-                - std::get<0>(jobs_intervals[jobs_intervals.size() - 1]);
+        munmap(addr, buf.st_size);
+        close(f_descriptor);
+        return;
     }
-#endif
 
-    template< typename T > PPL_FUNC_DECL void __freem(T* &_alloc){
-        if(_alloc != nullptr){
-            delete[] _alloc;
-            _alloc = nullptr;
-        }
+    std::istringstream s_stream;
+    s_stream.rdbuf()->pubsetbuf ( reinterpret_cast<char*>(addr), 
+                                    buf.st_size );
+    uint64_t _size =  num_of_p((char*)addr, buf.st_size);
+
+    if( _size%DIM != 0){
+        munmap(addr, buf.st_size);
+        close(f_descriptor);
+        throw std::logic_error("incompatible size of read data in the file <"+_dir+">, "
+                + std::to_string(_size)+" were read!");
     }
+    
+    _size /= DIM;
+    _points.clear();
+    _points.reserve(_size);
+
+    ppl::vertex<P_TYPE, DIM> point;
+    bool read{1};
+    while(read){
+        ppl::for_each_coord<DIM>([&](auto i){ 
+            read = read && (s_stream >> point.template get<i>()); });
+        if(read)
+            _points.push_back(point);
+    }
+    
+    munmap(addr, buf.st_size);
+    close(f_descriptor);
 
-    void cleanUp(void){
+    if( (_size -1)%ppl::cubic != 0 || _size <= ppl::cubic || _points.size() != _size)
+        throw std::logic_error("incompatible number of control points in the file <"+_dir+">, "
+                + std::to_string(_points.size())+" were read!");
 
-#ifdef PPL_CONCURRENCY
+#else
+        
+#error "loading control points from external file is not supported on this system!"
 
-        __freem(_track_strips);
-        __freem(thrd);
 #endif
+}
 
-#ifdef PPL_EXTERNAL_TRACK_LOADING
-        
-        __freem(points);
 #endif
 
-    }
+#ifdef PPL_CONCURRENCY
 
-public:
-    point_projection() = default;
-    virtual ~point_projection(){
-        
-        cleanUp();
+/*
+ * The path split into contiguous strips of curves, one strip per thread.
+ * 'strides[i]' is the index of the first curve of 'strips[i]' in the path.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> struct track_strips{
+    std::vector<ppl::cubic_path<P_TYPE, DIM>> strips;
+    std::vector<uint64_t> strides;
+};
 
-    }
+#endif
 
+template< typename P_TYPE, std::size_t DIM = 3> class point_projection
 
-#ifdef PLL_EXTERNAL_TRACK_LOADING
+{   
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::point_projection can only be with floating-point types!\n");
 
-    uint64_t num_of_p(char *addr, const uint64_t& len){
+public:
 
-        std::stringstream s_stream;
-        s_stream.rdbuf()->pubsetbuf(addr, len);
-        return std::distance(std::istream_iterator<std::string>(s_stream), 
-                std::istream_iterator<std::string>());
-    }
+    /*
+     * The precomputed path. It's immutable and reference counted, so any
+     * number of point_projection objects can share the same one.
+     */
+#ifdef PPL_CONCURRENCY
+    typedef std::shared_ptr<const ppl::track_strips<P_TYPE, DIM>> geometry;
+#else
+    typedef std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> geometry;
+#endif
 
+private:
 
-    PPL_FUNC_DECL static bool 
-    does_exist(const fs::path& _dir, 
-            fs::file_status _status = fs::file_status{})
-    {
-	    return (fs::status_known(_status) ? fs::exists(_status) : fs::exists(_dir));
-    }
+    geometry _track;
 
-    void routing(const std::string& _dir){
-        cleanUp();
-#ifdef __linux__
+    // where the paths built by this object are allocated from
+    std::pmr::memory_resource* _resource{std::pmr::get_default_resource()};
 
-        if(!does_exist(_dir))
-            throw std::invalid_argument("cannot find file <"+_dir+">\n" );
+#ifdef PPL_CONCURRENCY
 
-        f_descriptor = open(_dir.c_str(), O_RDONLY, S_IRUSR|S_IWUSR);
-        
-        if( f_descriptor < 0)
-            throw std::runtime_error("could not open file <"+_dir+">\n");
+    std::vector<ppl::projection<P_TYPE, DIM>> thr_verts;
 
-        if(fstat(f_descriptor,&buf) < 0){
-            close(f_descriptor);
-            throw std::runtime_error("not able to get file size <"+_dir+">\n");
-        }
+    static std::vector<std::tuple<uint64_t, uint64_t>> 
+    build_intervals(const std::size_t& _thrN, const uint64_t& tks_per_thr, 
+        const uint64_t& __size)
+    {
+        std::vector<std::tuple<uint64_t, uint64_t>> jobs_intervals;
+        std::tuple<uint64_t, uint64_t> tup;
+
+        std::get<0>(tup) = 0;
+        std::get<1>(tup) = (tks_per_thr * ppl::cubic) + 1;
+        jobs_intervals.push_back(tup);
 
-        addr = mmap(NULL, buf.st_size, 
-                PROT_READ, MAP_PRIVATE, f_descriptor, 0);
+        for (std::size_t j{1}; j < _thrN; ++j){
 
-        if(addr == MAP_FAILED){
-            close(f_descriptor);
-            throw std::runtime_error("an exception occurred while mapping the file <"+_dir+">\n");
+            std::get<0>(tup) = std::get<0>(jobs_intervals[j-1])
+                    + std::get<1>(jobs_intervals[j-1]) - 1;
+            std::get<1>(tup) =  (tks_per_thr * ppl::cubic) + 1;
+            jobs_intervals.push_back(tup);
         }
 
-        s_stream.rdbuf()->pubsetbuf ( reinterpret_cast<char*>(addr), 
-                                        buf.st_size );
-        _size =  num_of_p((char*)addr, buf.st_size);
+        std::get<1>(jobs_intervals[jobs_intervals.size() - 1]) = __size 
+                - std::get<0>(jobs_intervals[jobs_intervals.size() - 1]);
 
-        if( _size%ppl::cubic != 0){
-            munmap(addr, buf.st_size);
-            close(f_descriptor);
-            throw std::logic_error("incompatible size of read data in the file <"+_dir+">, "
-                    + std::to_string(_size)+" were read!");
-        }
-        
-        _size /= ppl::cubic;
-        points = new ppl::vertex<P_TYPE>[_size];
-
-        P_TYPE x{0}, y{0}, z{0};
-        std::size_t i{0};   
-        while(s_stream >> x >> y >> z)
-            points[i++] = ppl::vertex<P_TYPE>{ x, y, z};
-        s_stream.clear();
-        
-        munmap(addr, buf.st_size);
-        close(f_descriptor);
+        return jobs_intervals;
+    }
 
-        ppl_assert__((_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
-            "incompatible number of control points!");
+#else
 
+    bool _private_track{0};   // '_track' was built by this object, hence not created const
 
-#if defined PPL_CONCURRENCY   
+    // the path to be edited, copied first if it's shared with others
+    ppl::cubic_path<P_TYPE, DIM>& __modifiable(void){
+        ppl_assert__(_track != nullptr, 
+            "editing an empty path! did you forget to load your data?\n");
 
-        drafting_concur_attrib(this->points, this->_size);
+        if(!_private_track || _track.use_count() != 1){
+            _track = std::make_shared<ppl::cubic_path<P_TYPE, DIM>>(*_track);
+            _private_track = 1;
+        }
+        return const_cast<ppl::cubic_path<P_TYPE, DIM>&>(*_track);
+    }
 
-#else
-        _track.routing(this->points, this->_size);
-         
 #endif
 
-#else
-        
-#error "loading control points from external file is not supported on this system!"
+public:
+    point_projection() = default;
+    point_projection(const point_projection&) = default;
+    point_projection(point_projection&&) = default;
+    point_projection& operator=(const point_projection&) = default;
+    point_projection& operator=(point_projection&&) = default;
+    virtual ~point_projection() = default;
+
+    /*
+     * Paths loaded by this object are allocated from '__resource', which has
+     * to outlive them, see ppl::cubic_path.
+     */
+    explicit point_projection(std::pmr::memory_resource* __resource) : _resource{__resource} {
+        ppl_assert__(_resource != nullptr, "invalid memory resource!");
+    }
 
+    // uses an already built path, e.g. one shared by another point_projection
+    explicit point_projection(geometry __track) : _track{std::move(__track)} {
+        ppl_assert__(_track != nullptr, "sharing an empty path!");
+#ifdef PPL_CONCURRENCY
+        thr_verts.resize(_track->strips.size());
 #endif
+    }
 
+    // the path of this object, to be shared with other objects
+    geometry share(void) const { return _track; }
+
+
+#ifdef PPL_EXTERNAL_TRACK_LOADING
+
+    void routing(const std::string& _dir){
+        std::vector<ppl::vertex<P_TYPE, DIM>> __points;
+        ppl::load_control_points(_dir, __points);
+
+        routing(__points.data(), __points.size());
     }
     
     point_projection(const std::string& _dir){
@@ -253,85 +306,151 @@ public:
 
 #endif
 
-    point_projection(ppl::vertex<P_TYPE> const * const _points,
+    // decodes the whole path, see ppl::packed_track::decode_curves for a part of it
+    void routing(const ppl::packed_track& _packed){
+        static_assert(DIM == 3, "packed tracks hold 3D control points!");
+        std::vector<ppl::vertex<P_TYPE, DIM>> __points;
+        _packed.decode(__points);
+
+        routing(__points.data(), __points.size());
+    }
+
+    explicit point_projection(const ppl::packed_track& _packed){
+        routing(_packed);
+    }
+
+    point_projection(ppl::vertex<P_TYPE, DIM> const * const _points,
         const uint64_t& __size) {
         
         routing(_points, __size);
     }
 
-    void routing(ppl::vertex<P_TYPE> const * const _points, 
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
                 const uint64_t& __size){
-        ppl_assert__( (__size -1)%ppl::cubic == 0 && __size > ppl::cubic, 
-                "incompatible number of control points!" );
-
-        cleanUp();
+        __routing(_points, __size);
+    }
 
-#if defined PPL_CONCURRENCY 
+    /*
+     * The path references the given control points instead of copying them,
+     * see ppl::cubic_path. They have to outlive the path.
+     */
+    point_projection(ppl::vertex<P_TYPE, DIM> const * const _points,
+        const uint64_t& __size, ppl::borrow_points_t) {
+        
+        routing(_points, __size, ppl::borrow_points);
+    }
 
-        drafting_concur_attrib(_points, __size);
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, ppl::borrow_points_t){
+        __routing(_points, __size, ppl::borrow_points);
+    }
 
-#else
-        _track.routing(_points, __size);
-         
-#endif
+    /*
+     * Only the control points are kept, the coefficients are recomputed by
+     * every query, see ppl::cubic_path. Can be combined with borrowing.
+     */
+    point_projection(ppl::vertex<P_TYPE, DIM> const * const _points,
+        const uint64_t& __size, ppl::lean_coeffs_t) {
         
+        routing(_points, __size, ppl::lean_coeffs);
     }
 
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, ppl::lean_coeffs_t){
+        __routing(_points, __size, ppl::lean_coeffs);
+    }
 
-#if defined PPL_CONCURRENCY 
-    
-    void drafting_concur_attrib(ppl::vertex<P_TYPE> const * const _points, 
-        const uint64_t& __size){
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, ppl::borrow_points_t, ppl::lean_coeffs_t){
+        __routing(_points, __size, ppl::borrow_points, ppl::lean_coeffs);
+    }
 
-        splinesN = (__size-1)/ppl::cubic;
-      
+    /*
+     * The coefficients of a tile of curves are computed by the first query
+     * reaching it, see ppl::cubic_path. Can be combined with borrowing.
+     */
+    point_projection(ppl::vertex<P_TYPE, DIM> const * const _points,
+        const uint64_t& __size, ppl::lazy_coeffs_t) {
+        
+        routing(_points, __size, ppl::lazy_coeffs);
+    }
 
-#if defined(_WIN32) || defined(WIN32) 
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, ppl::lazy_coeffs_t){
+        __routing(_points, __size, ppl::lazy_coeffs);
+    }
 
-        _SYSTEM_INFO sysinfo;
-        GetSystemInfo(&sysinfo);
-        _thrN = sysinfo.dwNumberOfProcessors;
+    void routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, ppl::borrow_points_t, ppl::lazy_coeffs_t){
+        __routing(_points, __size, ppl::borrow_points, ppl::lazy_coeffs);
+    }
 
-#elif defined __linux__
+private:
 
-        _thrN = sysconf(_SC_NPROCESSORS_CONF); 
+    /*
+     * Builds the path, the tags of the mode are passed on to
+     * ppl::cubic_path::routing as they are. With PPL_CONCURRENCY the path
+     * is split into one strip per processor.
+     */
+    template<typename... TAGS>
+    void __routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, TAGS... tags){
+        ppl_assert__( (__size -1)%ppl::cubic == 0 && __size > ppl::cubic, 
+                "incompatible number of control points!" );
 
-#else
-        
-#error "multithreading support is not supported on this system!"
+#if defined PPL_CONCURRENCY 
 
-#endif
-        _track_strips = new ppl::cubic_path<P_TYPE>[_thrN];
+        uint64_t splinesN = (__size-1)/ppl::cubic;
+        std::size_t _thrN{ppl::processors()};
 
         if(_thrN>splinesN) 
             _thrN = splinesN;
-        thrd = new _channel*[_thrN];
 
-        thr_verts.resize(_thrN);
+        std::vector<std::tuple<uint64_t, uint64_t>> jobs_intervals{
+                        build_intervals(_thrN, splinesN/_thrN, __size)};
 
-        build_intervals(splinesN/_thrN, __size);
+        std::shared_ptr<ppl::track_strips<P_TYPE, DIM>> __track{
+                        std::make_shared<ppl::track_strips<P_TYPE, DIM>>()};
+        __track->strips.reserve(_thrN);
+        __track->strides.resize(_thrN);
         
         for(std::size_t i{0}; i < jobs_intervals.size(); ++i)
         {
-            _track_strips[i].routing(_points+std::get<0>(jobs_intervals[i]), 
-                        std::get<1>(jobs_intervals[i]));
+            __track->strips.emplace_back(_resource);
+            __track->strides[i] = std::get<0>(jobs_intervals[i])/ppl::cubic;
+            __track->strips[i].routing(_points+std::get<0>(jobs_intervals[i]), 
+                        std::get<1>(jobs_intervals[i]), tags...);
         }
-    }
 
+        _track = std::move(__track);
+        thr_verts.resize(_thrN);
+
+#else
+        std::shared_ptr<ppl::cubic_path<P_TYPE, DIM>> __track{
+                        std::make_shared<ppl::cubic_path<P_TYPE, DIM>>(_resource)};
+        __track->routing(_points, __size, tags...);
+        _track = std::move(__track);
+        _private_track = 1;
+         
 #endif
+    }
 
+public:
 
-    ppl::projection<P_TYPE> localize(ppl::vertex<P_TYPE> const * const p)
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p)
     
     {
+        ppl_assert__(_track != nullptr, 
+            "closest point was called on empty data! did you forget to load your data?\n");
 
 #if defined PPL_CONCURRENCY
 
-        int32_t i, min_ind, _stride{0};
+        int32_t i, min_ind, _thrN = static_cast<int32_t>(_track->strips.size());
+        std::vector<_channel*> thrd(_thrN);
 
         for (i = _thrN-1; i >=0 ; --i)
-            thrd[i] = new _channel( ppl::thrStr<P_TYPE>::_task, 3, 
-                        &_track_strips[i], p, &thr_verts[i]);
+            thrd[i] = new _channel( ppl::thrStr<P_TYPE, DIM>::_task, 3, 
+                        (void*)&_track->strips[i], p, &thr_verts[i]);
 
         for (i = _thrN-1; i >=0 ; --i)
             thrd[i]->join(nullptr);
@@ -341,26 +460,50 @@ public:
 
         min_ind = std::min_element(thr_verts.begin(), 
                         thr_verts.end(),
-                        [](const ppl::projection<P_TYPE> v1, 
-                                const ppl::projection<P_TYPE> v2)
+                        [](const ppl::projection<P_TYPE, DIM> v1, 
+                                const ppl::projection<P_TYPE, DIM> v2)
                         ->bool{return v1.dist<v2.dist;} ) - thr_verts.begin(); 
 
-
-        if(min_ind == 0)
-            return thr_verts[0];
-            
-        for( i = 0; i < min_ind; ++i)
-            _stride+= ( std::get<1>(jobs_intervals[i]) -1)/ppl::cubic;
-
-        thr_verts[min_ind].index += _stride;
+        thr_verts[min_ind].index += _track->strides[min_ind];
 
         return  thr_verts[min_ind];
 #else 
 
-        return _track.closest_point(p);
+        return _track->closest_point(p);
         
 #endif
     }
+
+#if !defined PPL_CONCURRENCY
+
+    /*
+     * In-place editing of the loaded path, see ppl::cubic_path. Not available
+     * with multithreading support, where the path is split between threads.
+     * If the path is shared with other objects, this object gets its own
+     * copy of it first, the others are not affected.
+     */
+    uint64_t curves(void) const { return _track == nullptr? 0 : _track->curves(); }
+
+    void append(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size){
+        __modifiable().append(_points, __size);
+    }
+
+    void erase(const uint64_t& _first, const uint64_t& _count){
+        __modifiable().erase(_first, _count);
+    }
+
+    void splice(const uint64_t& _first, const uint64_t& _count,
+                ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size){
+        __modifiable().splice(_first, _count, _points, __size);
+    }
+
+    void move_control_point(const uint64_t& _ind, const ppl::vertex<P_TYPE, DIM>& _point){
+        __modifiable().move_control_point(_ind, _point);
+    }
+
+#endif
 };
 
 
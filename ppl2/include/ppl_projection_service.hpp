@@ -0,0 +1,537 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_PROJECTION_SERVICE_HPP
+#define PPL_PROJECTION_SERVICE_HPP
+
+
+#ifdef PPL_PROJECTION_SERVICE
+
+#if !defined(__linux__) || !__has_include(<sys/socket.h>)
+#error "the projection service is only supported on Linux!"
+#endif
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+
+namespace ppl
+{
+
+/*
+ * The wire of the local projection service, a Unix domain socket of
+ * sequenced packets "each message arrives whole, or not at all". Server
+ * and clients run on the same host, so vertices and projections travel as
+ * they are laid out in memory. The server announces its layouts first:
+ *
+ *   server -> client   hello
+ *   client -> server   vertex<P_TYPE, DIM>       points[n]    // 0 < n <= batch
+ *   server -> client   projection<P_TYPE, DIM>   answers[n]   // in the same order
+ *                   or rejection                              // a point isn't finite
+ *
+ * A client reads the answer of a request before sending the next one.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> struct service_wire
+{
+    static constexpr char magic[4]={'P', 'P', 'L', 'V'};
+    static constexpr uint32_t version{2};
+
+    // points of a request at most, so that its answer fits the socket buffers
+    static constexpr uint32_t batch{1024};
+
+    struct hello{
+        char magic[4];
+        uint32_t version;
+        uint32_t dim;
+        uint32_t vertex_bytes;
+        uint32_t projection_bytes;
+        uint32_t batch;
+    };
+
+    // the answer of a request holding a NaN or infinite coordinate, shorter than any projection
+    struct rejection{
+        char magic[4];
+        uint32_t points;
+    };
+    static_assert(sizeof(rejection) < sizeof(ppl::projection<P_TYPE, DIM>), 
+        "a rejection must not be mistaken for an answer!\n");
+
+    static rejection rejected(const uint32_t& _points){
+        rejection r{};
+        memcpy(r.magic, magic, sizeof(magic));
+        r.points = _points;
+        return r;
+    }
+
+    static bool finite(ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _count){
+        bool _finite{true};
+        for(uint64_t i{0}; i < _count; ++i)
+            ppl::for_each_coord<DIM>([&](auto k){ 
+                _finite = _finite && std::isfinite(_points[i].template get<k>()); });
+        return _finite;
+    }
+
+    static hello greeting(void){
+        hello h{};
+        memcpy(h.magic, magic, sizeof(magic));
+        h.version = version;
+        h.dim = DIM;
+        h.vertex_bytes = sizeof(ppl::vertex<P_TYPE, DIM>);
+        h.projection_bytes = sizeof(ppl::projection<P_TYPE, DIM>);
+        h.batch = batch;
+        return h;
+    }
+
+    static sockaddr_un address(const std::string& _socket){
+        sockaddr_un addr{};
+        if(_socket.empty() || _socket.size() >= sizeof(addr.sun_path))
+            throw std::invalid_argument("invalid path of socket <"+_socket+">\n");
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, _socket.c_str(), _socket.size());
+        return addr;
+    }
+};
+
+
+#ifdef PPL_CONCURRENCY
+
+/*
+ * Serves the path of a point_projection to the processes of the host, so
+ * that they share one precomputed path instead of each loading it. The
+ * requests arriving within 'window' of the first one pending are coalesced,
+ * and the whole batch is projected in one pass spread over the processors.
+ *
+ * run() serves on the calling thread until stop() is called, from another
+ * thread or from a signal handler. Serving can be resumed by run().
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class projection_server
+{
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::projection_server can only be with floating-point types!\n");
+
+    typedef ppl::service_wire<P_TYPE, DIM> wire;
+
+    // the requests of a batch, each answered on its own
+    struct _request{
+        signed client;
+        uint64_t first;
+        uint64_t count;
+        bool rejected;   // not projected, answered with a rejection
+    };
+
+    typename ppl::point_projection<P_TYPE, DIM>::geometry _track;
+    std::string socket_path;
+    std::chrono::microseconds window;
+
+    signed listener{-1};
+    signed wake[2]{-1, -1};    // a pipe stop() writes to
+    std::vector<pollfd> fds;   // the pipe, the listener, then the clients
+
+    std::vector<ppl::vertex<P_TYPE, DIM>> queries;
+    std::vector<ppl::projection<P_TYPE, DIM>> answers;
+    std::vector<_request> pending;
+
+    // points of a batch at most, more requests wait for the next one
+    static constexpr uint64_t COALESCE{wire::batch*16};
+
+    std::atomic<uint64_t> _requests{0}, _batches{0}, _points{0}, _clients{0};
+
+
+    // the strips are scanned one after another, the batch keeps the processors busy
+    PPL_FUNC_DECL ppl::projection<P_TYPE, DIM> __localize(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        ppl::projection<P_TYPE, DIM> best{_track->strips[0].closest_point(p)};
+        best.index += _track->strides[0];
+        for(std::size_t i{1}; i < _track->strips.size(); ++i){
+            ppl::projection<P_TYPE, DIM> curr{_track->strips[i].closest_point(p)};
+            if(curr.dist < best.dist){
+                best = curr;
+                best.index += _track->strides[i];
+            }
+        }
+        return best;
+    }
+
+    void __project(const uint64_t& _first, const uint64_t& _last){
+        for(uint64_t i{_first}; i < _last; ++i)
+            answers[i] = __localize(&queries[i]);
+    }
+
+    static void* __project_task(void* argv){
+
+        projection_server* server = (projection_server*) ((void**)argv)[0];
+        const uint64_t* const range = (const uint64_t*) ((void**)argv)[1];
+
+        server->__project(range[0], range[1]);
+
+        pthread_exit(nullptr);
+        return nullptr;
+    }
+
+    // projects the batch and answers its requests
+    void __flush(void)
+    {
+        answers.resize(queries.size());
+
+        const uint64_t _thrN{std::min<uint64_t>(ppl::processors(), queries.size())};
+        if(_thrN > 0){
+            std::vector<uint64_t> bounds(_thrN+1);
+            for(uint64_t i{0}; i <= _thrN; ++i)
+                bounds[i] = queries.size()*i/_thrN;
+
+            std::vector<std::unique_ptr<ppl::_channel>> thrd(_thrN);
+            for(uint64_t i{1}; i < _thrN; ++i)
+                thrd[i] = std::make_unique<ppl::_channel>(__project_task, 2, 
+                            (void*)this, (void*)&bounds[i]);
+
+            __project(bounds[0], bounds[1]);
+
+            for(uint64_t i{1}; i < _thrN; ++i)
+                thrd[i]->join(nullptr);
+        }
+
+        // a packet goes whole or not at all, a client whose answer can't be queued is dropped
+        std::vector<signed> _lost;
+        for(const _request& r : pending){
+            if(std::find(_lost.begin(), _lost.end(), r.client) != _lost.end())
+                continue;
+            const typename wire::rejection _rejection{wire::rejected(r.count)};
+            const std::size_t _bytes{r.rejected? sizeof(_rejection) 
+                        : sizeof(ppl::projection<P_TYPE, DIM>)*r.count};
+            const void* const _answer{r.rejected? static_cast<const void*>(&_rejection) 
+                        : static_cast<const void*>(answers.data() + r.first)};
+            ssize_t _sent;
+            do
+                _sent = send(r.client, _answer, _bytes, MSG_NOSIGNAL);
+            while(_sent < 0 && errno == EINTR);
+            if(_sent < 0 || static_cast<std::size_t>(_sent) != _bytes)
+                _lost.push_back(r.client);
+        }
+        for(const signed& client : _lost)
+            __drop(std::find_if(fds.begin(), fds.end(), 
+                        [&](const pollfd& f){ return f.fd == client; }) - fds.begin());
+
+        _batches.fetch_add(1, std::memory_order_relaxed);
+        _points.fetch_add(queries.size(), std::memory_order_relaxed);
+        queries.clear();
+        pending.clear();
+    }
+
+    void __accept(void)
+    {
+        const signed client{accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+        if(client < 0)
+            return;
+
+        const typename wire::hello h{wire::greeting()};
+        if(send(client, &h, sizeof(h), MSG_NOSIGNAL) != sizeof(h)){
+            close(client);
+            return;
+        }
+        fds.push_back(pollfd{client, POLLIN, 0});
+        _clients.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // takes the requests of a client into the batch, false if it's gone or broke the protocol
+    bool __receive(const signed& _client)
+    {
+        for(;;){
+            const uint64_t _first{queries.size()};
+            queries.resize(_first + wire::batch);
+            const ssize_t _bytes{recv(_client, queries.data() + _first, 
+                        sizeof(ppl::vertex<P_TYPE, DIM>)*wire::batch, MSG_DONTWAIT | MSG_TRUNC)};
+
+            if(_bytes <= 0 || _bytes%sizeof(ppl::vertex<P_TYPE, DIM>) != 0 
+                    || static_cast<std::size_t>(_bytes) > sizeof(ppl::vertex<P_TYPE, DIM>)*wire::batch){
+                queries.resize(_first);
+                return _bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+            }
+
+            // a point which isn't finite has no projection, the request is rejected whole
+            const uint64_t _count{_bytes/sizeof(ppl::vertex<P_TYPE, DIM>)};
+            const bool _rejected{!wire::finite(queries.data() + _first, _count)};
+            queries.resize(_rejected? _first : _first + _count);
+            pending.push_back(_request{_client, _first, _count, _rejected});
+            _requests.fetch_add(1, std::memory_order_relaxed);
+            if(queries.size() >= COALESCE)
+                return true;
+        }
+    }
+
+    void __drop(const std::size_t& _i)
+    {
+        const signed client{fds[_i].fd};
+        pending.erase(std::remove_if(pending.begin(), pending.end(), 
+                    [&](const _request& r){ return r.client == client; }), pending.end());
+        close(client);
+        fds.erase(fds.begin() + _i);
+    }
+
+    // waits up to '_timeout' for requests, or for ever if it's null, false once stopped
+    bool __poll(const timespec* const _timeout)
+    {
+        if(ppoll(fds.data(), fds.size(), _timeout, nullptr) < 0)
+            return errno == EINTR;
+        if(fds[0].revents != 0){
+            char c[16];
+            while(read(wake[0], c, sizeof(c)) > 0){}
+            return false;
+        }
+        if(fds[1].revents & POLLIN)
+            __accept();
+
+        for(std::size_t i{fds.size()}; i-- > 2; ){
+            if(fds[i].revents == 0 || queries.size() >= COALESCE)
+                continue;
+            if(!__receive(fds[i].fd) || ((fds[i].revents & (POLLHUP | POLLERR)) 
+                        && !(fds[i].revents & POLLIN)))
+                __drop(i);
+        }
+        return true;
+    }
+
+    void cleanUp(void)
+    {
+        for(std::size_t i{2}; i < fds.size(); ++i)
+            close(fds[i].fd);
+        fds.clear();
+        if(listener >= 0){
+            close(listener);
+            unlink(socket_path.c_str());
+        }
+        if(wake[0] >= 0){
+            close(wake[0]);
+            close(wake[1]);
+        }
+        listener = wake[0] = wake[1] = -1;
+    }
+
+public:
+
+    /*
+     * Serves the path of '_path' on the socket '_socket', replacing a socket
+     * left there. The path is shared, not copied.
+     */
+    projection_server(const std::string& _socket, 
+            const ppl::point_projection<P_TYPE, DIM>& _path, 
+            const std::chrono::microseconds& _window = std::chrono::microseconds(200))
+        : _track{_path.share()}, socket_path{_socket}, window{_window}
+    {
+        ppl_assert__(_track != nullptr, 
+            "serving an empty path! did you forget to load your data?\n");
+
+        const sockaddr_un addr{wire::address(socket_path)};
+        listener = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(listener < 0)
+            throw std::runtime_error("could not create socket <"+socket_path+">\n");
+
+        unlink(socket_path.c_str());
+        if(bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 
+                || listen(listener, SOMAXCONN) < 0){
+            close(listener);
+            listener = -1;
+            throw std::runtime_error("could not listen on socket <"+socket_path+">\n");
+        }
+        if(pipe2(wake, O_NONBLOCK | O_CLOEXEC) < 0){
+            cleanUp();
+            throw std::runtime_error("could not create the pipe of socket <"+socket_path+">\n");
+        }
+
+        fds.push_back(pollfd{wake[0], POLLIN, 0});
+        fds.push_back(pollfd{listener, POLLIN, 0});
+        queries.reserve(COALESCE + wire::batch);
+    }
+
+    projection_server(const projection_server&) = delete;
+    projection_server& operator=(const projection_server&) = delete;
+
+    virtual ~projection_server(){ cleanUp(); }
+
+    // serves until stop() is called
+    void run(void)
+    {
+        for(;;){
+            if(!__poll(nullptr))
+                return;
+            if(pending.empty())
+                continue;
+
+            // the window opened by the first request of the batch
+            const auto deadline{std::chrono::steady_clock::now() + window};
+            for(auto now{std::chrono::steady_clock::now()}; 
+                    now < deadline && queries.size() < COALESCE; now = std::chrono::steady_clock::now()){
+                const auto left{std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now)};
+                const timespec _left{static_cast<time_t>(left.count()/1000000000), 
+                            static_cast<long>(left.count()%1000000000)};
+                if(!__poll(&_left))
+                    return;
+            }
+            if(!pending.empty())
+                __flush();
+        }
+    }
+
+    // async-signal-safe
+    void stop(void){
+        const char c{0};
+        if(write(wake[1], &c, 1) < 0){}
+    }
+
+    uint64_t requests(void) const { return _requests.load(std::memory_order_relaxed); }
+    uint64_t batches(void) const { return _batches.load(std::memory_order_relaxed); }
+    uint64_t points(void) const { return _points.load(std::memory_order_relaxed); }
+    uint64_t clients(void) const { return _clients.load(std::memory_order_relaxed); }
+};
+
+#endif
+
+
+/*
+ * A client of a projection_server of the host. A client is used by one
+ * thread at a time, threads may open clients of their own.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class projection_client
+{
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::projection_client can only be with floating-point types!\n");
+
+    typedef ppl::service_wire<P_TYPE, DIM> wire;
+
+    signed f_descriptor{-1};
+    std::string socket_path;
+
+public:
+
+    explicit projection_client(const std::string& _socket): socket_path{_socket}
+    {
+        const sockaddr_un addr{wire::address(socket_path)};
+        f_descriptor = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if(f_descriptor < 0)
+            throw std::runtime_error("could not create socket <"+socket_path+">\n");
+        if(connect(f_descriptor, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0){
+            close(f_descriptor);
+            throw std::runtime_error("could not connect to socket <"+socket_path+">\n");
+        }
+
+        typename wire::hello h{}; 
+        const typename wire::hello expected{wire::greeting()};
+        if(recv(f_descriptor, &h, sizeof(h), 0) != sizeof(h) 
+                || memcmp(h.magic, expected.magic, sizeof(h.magic)) != 0 || h.version != expected.version){
+            close(f_descriptor);
+            throw std::invalid_argument("not a projection server <"+socket_path+">\n");
+        }
+        if(h.dim != expected.dim || h.vertex_bytes != expected.vertex_bytes 
+                || h.projection_bytes != expected.projection_bytes || h.batch != expected.batch){
+            close(f_descriptor);
+            throw std::invalid_argument("the projection server holds other vertices <"+socket_path+">\n");
+        }
+    }
+
+    projection_client(const projection_client&) = delete;
+    projection_client& operator=(const projection_client&) = delete;
+
+    virtual ~projection_client(){ close(f_descriptor); }
+
+    /*
+     * Sends a request of '_count' points, at most service_wire::batch, and
+     * returns at once. Its answer is read by collect(), so that requests to
+     * several servers run at the same time.
+     */
+    void post(ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _count)
+    {
+        ppl_assert__(_count > 0 && _count <= wire::batch, "incompatible number of points!");
+        if(send(f_descriptor, _points, sizeof(ppl::vertex<P_TYPE, DIM>)*_count, MSG_NOSIGNAL) < 0)
+            throw std::runtime_error("lost the projection server <"+socket_path+">\n");
+    }
+
+    /*
+     * Waits for the answer of the request posted last. A request holding a
+     * NaN or infinite coordinate is rejected by the server, which throws
+     * std::invalid_argument, the client stays usable.
+     */
+    void collect(ppl::projection<P_TYPE, DIM> * const _answers, const uint64_t& _count)
+    {
+        const std::size_t _bytes{sizeof(ppl::projection<P_TYPE, DIM>)*_count};
+        ssize_t _read;
+        do
+            _read = recv(f_descriptor, _answers, _bytes, 0);
+        while(_read < 0 && errno == EINTR);
+
+        if(_read == sizeof(typename wire::rejection)){
+            typename wire::rejection r;
+            memcpy(&r, _answers, sizeof(r));
+            if(memcmp(r.magic, wire::magic, sizeof(r.magic)) == 0 && r.points == _count)
+                throw std::invalid_argument("a query point isn't finite <"+socket_path+">\n");
+        }
+        if(_read < 0 || static_cast<std::size_t>(_read) != _bytes)
+            throw std::runtime_error("lost the projection server <"+socket_path+">\n");
+    }
+
+    // projects '_size' points, sent in requests of service_wire::batch points at most
+    void localize(ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _size, 
+                ppl::projection<P_TYPE, DIM> * const _answers)
+    {
+        for(uint64_t _first{0}; _first < _size; _first += wire::batch){
+            const uint64_t _count{std::min<uint64_t>(wire::batch, _size - _first)};
+            post(_points + _first, _count);
+            collect(_answers + _first, _count);
+        }
+    }
+
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p)
+    {
+        ppl::projection<P_TYPE, DIM> answer;
+        localize(p, 1, &answer);
+        return answer;
+    }
+};
+
+
+} // namespace ppl
+
+
+#endif   // PPL_PROJECTION_SERVICE
+
+
+#endif   //  PPL_PROJECTION_SERVICE_HPP
@@ -44,6 +44,18 @@
 namespace ppl
 {
 
+// the number of processors the work of a path is spread over
+inline std::size_t processors(void)
+{
+#if defined(_WIN32) || defined(WIN32) 
+    _SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors;
+#else
+    return sysconf(_SC_NPROCESSORS_CONF); 
+#endif
+}
+
 class _channel
 {
     pthread_t id;
@@ -0,0 +1,335 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_SEGMENT_PATH_HPP
+#define PPL_SEGMENT_PATH_HPP
+
+
+
+#include "ppl_numeric_mth.hpp"
+
+
+namespace ppl
+{
+
+/*
+ * A read-only path whose segments are lines, quadratics or cubics, each
+ * given its own degree. Consecutive segments share their end points, so a
+ * path of n segments of degrees d0..dn-1 has 1 + d0 + ... + dn-1 control
+ * points.
+ *
+ * The segments are stored in one batch per degree, in power basis, and a
+ * query runs over each batch with the kernel of its degree: a clamped dot
+ * product for lines, the closed-form cubic for quadratics and the quintic
+ * for cubics. Every batch keeps the index of its segments in the path, so
+ * projection.index is the index of the segment in the path, as in
+ * cubic_path, and projection.parameter its local parameter.
+ */
+template<typename P_TYPE, std::size_t DIM = 3>
+class segment_path : public ppl::curve_solver<P_TYPE, DIM>
+{
+
+    struct _line{
+        ppl::vertex<P_TYPE, DIM> a1, a0;
+    };
+
+    struct _quadratic{
+        ppl::vertex<P_TYPE, DIM> a2, a1, a0;
+    };
+
+    struct _cubic{
+        ppl::poly3d<P_TYPE, DIM> parametric;
+        ppl::deriv3d<P_TYPE, DIM> deriv;
+        ppl::poly1d<P_TYPE> poly;
+    };
+
+    template<typename SEGMENT> struct _batch{
+        std::pmr::vector<SEGMENT> segments;
+        std::pmr::vector<uint64_t> index;   // of each segment in the path
+
+        explicit _batch(std::pmr::memory_resource* __resource): 
+            segments(__resource), index(__resource) {}
+
+        void clear(void) { segments.clear(); index.clear(); }
+
+        std::size_t footprint(void) const {
+            return sizeof(SEGMENT)*segments.capacity() + sizeof(uint64_t)*index.capacity();
+        }
+    };
+
+    _batch<_line> lines_;
+    _batch<_quadratic> quadratics_;
+    _batch<_cubic> cubics_;
+    ppl::vertex<P_TYPE, DIM> start;   // of the first segment
+    uint64_t segments_{0};
+
+    // where a query's best segment lives
+    enum class _kind : uint8_t { line, quadratic, cubic };
+    struct _slot{
+        _kind kind{_kind::line};
+        uint64_t pos{0};
+    };
+    _slot first;
+
+    using ppl::curve_solver<P_TYPE, DIM>::DEGREE_EPS;
+    using ppl::curve_solver<P_TYPE, DIM>::extract_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::call_significant_fig_ascertain;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_line;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_quadratic;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_curve;
+    using ppl::curve_solver<P_TYPE, DIM>::poly3d_solve_for;
+    using ppl::curve_solver<P_TYPE, DIM>::deriv3d_solve_for;
+
+
+    void add_line(const uint64_t& i, const ppl::vertex<P_TYPE, DIM>& a1, 
+                const ppl::vertex<P_TYPE, DIM>& a0){
+        if(i == 0) first = _slot{_kind::line, lines_.segments.size()};
+        lines_.segments.push_back(_line{a1, a0});
+        lines_.index.push_back(i);
+    }
+
+    void add_quadratic(const uint64_t& i, const ppl::vertex<P_TYPE, DIM>& a2, 
+                const ppl::vertex<P_TYPE, DIM>& a1, const ppl::vertex<P_TYPE, DIM>& a0)
+    {
+        // a straight quadratic is a line, see project_on_quadratic
+        if(a2.dot(a2) <= DEGREE_EPS*(a1.dot(a1) + a0.dot(a0))){
+            add_line(i, a1, a0);
+            return;
+        }
+        if(i == 0) first = _slot{_kind::quadratic, quadratics_.segments.size()};
+        quadratics_.segments.push_back(_quadratic{a2, a1, a0});
+        quadratics_.index.push_back(i);
+    }
+
+    void add_cubic(const uint64_t& i, const ppl::vertex<P_TYPE, DIM>* const points)
+    {
+        _cubic c;
+        if(!extract_coeffs(points, c.parametric, c.deriv, c.poly)){
+            // a degree-elevated quadratic or line
+            add_quadratic(i, c.parametric.coeffs[1], c.parametric.coeffs[2], c.parametric.coeffs[3]);
+            return;
+        }
+        if(i == 0) first = _slot{_kind::cubic, cubics_.segments.size()};
+        cubics_.segments.push_back(c);
+        cubics_.index.push_back(i);
+    }
+
+    void add(const uint64_t& i, const uint8_t& degree, 
+                const ppl::vertex<P_TYPE, DIM>* const c)
+    {
+        switch(degree){
+            case 1: add_line(i, c[1] - c[0], c[0]); break;
+            case ppl::quadratic: add_quadratic(i, c[0] - 2*c[1] + c[2], 2*(c[1] - c[0]), c[0]); break;
+            default: add_cubic(i, c); break;
+        }
+    }
+
+    void clear(void){
+        lines_.clear();
+        quadratics_.clear();
+        cubics_.clear();
+        segments_ = 0;
+        first = _slot{};
+    }
+
+    /*
+     * Runs 'project' over the segments of a batch, 'end' gives the end
+     * point of a segment. A tie on a shared end point goes to the earlier
+     * segment, as in cubic_path where the segments are scanned in order.
+     */
+    template<typename SEGMENT, typename END, typename PROJECT>
+    PPL_FUNC_DECL void scan(const _batch<SEGMENT>& batch, _kind kind, 
+                const ppl::vertex<P_TYPE, DIM>& p, P_TYPE& min_dist, P_TYPE& _param, 
+                _slot& best, uint64_t& best_index, END end, PROJECT project) const
+    {
+        const SEGMENT* const s = batch.segments.data();
+        for(uint64_t i{0}; i<batch.segments.size(); ++i)
+        {
+            const P_TYPE curr_dist{p.sqr_dist(end(s[i]))};
+            if (min_dist > curr_dist || (min_dist == curr_dist && batch.index[i] < best_index)){
+                best = _slot{kind, i};
+                best_index = batch.index[i];
+                _param = static_cast<P_TYPE>(1);
+                min_dist = curr_dist;
+            }
+
+            if(project(s[i], p, min_dist, _param)){
+                best = _slot{kind, i};
+                best_index = batch.index[i];
+            }
+        }
+    }
+
+public:
+
+    explicit segment_path(std::pmr::memory_resource* __resource = std::pmr::get_default_resource()):
+            lines_(__resource), quadratics_(__resource), cubics_(__resource)
+    {
+        ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559, 
+            "instantiation of ppl::segment_path can only be with floating-point types!\n");
+    }
+
+    segment_path(const ppl::vertex<P_TYPE, DIM>* const points, const uint64_t& _size, 
+            const uint8_t* const degrees, const uint64_t& _segments): segment_path() {
+        routing(points, _size, degrees, _segments);
+    }
+
+    segment_path(const ppl::vertex<P_TYPE, DIM>* const points, 
+            const uint64_t& _size): segment_path() {
+        routing(points, _size);
+    }
+
+
+    /*
+     * 'degrees' holds the degree "1, 2 or 3" of each of the '_segments'
+     * segments of the path.
+     */
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, const uint64_t& _size, 
+                const uint8_t* const degrees, const uint64_t& _segments)
+    {
+        uint64_t _points{1};
+        for(uint64_t i{0}; i<_segments; ++i){
+            ppl_assert__(degrees[i] >= 1 && degrees[i] <= ppl::cubic, 
+                "a segment can only be a line, a quadratic or a cubic!");
+            _points += degrees[i];
+        }
+        ppl_assert__(_segments > 0 && _size == _points, "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        clear();
+        start = points[0];
+        segments_ = _segments;
+        for(uint64_t i{0}, j{0}; i<_segments; j+=degrees[i], ++i)
+            add(i, degrees[i], points+j);
+    }
+
+    /*
+     * A path of cubic curves "3n+1 layout" whose degree-elevated lines and
+     * quadratics are stored, and projected on, with their actual degree.
+     */
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size)
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        clear();
+        start = points[0];
+        segments_ = (_size-1)/ppl::cubic;
+        for(uint64_t i{0}; i<segments_; ++i)
+            add_cubic(i, points+i*ppl::cubic);
+    }
+
+
+    PPL_FUNC_DECL ppl::projection<P_TYPE, DIM> 
+    closest_point(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        ppl_assert__(segments_ > 0, 
+            "closest point was called on empty data! did you forget to load your data?\n");
+
+        ppl::projection<P_TYPE, DIM> point_projection;
+        point_projection.parameter = 0;
+        _slot best{first};
+        uint64_t best_index{0};
+
+        P_TYPE min_dist{(*p).sqr_dist(start)};
+        ppl::solver_scratch<P_TYPE, ALTERS_PRECISION> scratch;
+
+        scan(lines_, _kind::line, *p, min_dist, point_projection.parameter, 
+            best, best_index, 
+            [](const _line& s){ return s.a1 + s.a0; },
+            [this](const _line& s, const ppl::vertex<P_TYPE, DIM>& q, P_TYPE& d, P_TYPE& t){
+                return project_on_line(s.a0, s.a1, q, d, t); });
+
+        scan(quadratics_, _kind::quadratic, *p, min_dist, point_projection.parameter, 
+            best, best_index, 
+            [](const _quadratic& s){ return s.a2 + s.a1 + s.a0; },
+            [this](const _quadratic& s, const ppl::vertex<P_TYPE, DIM>& q, P_TYPE& d, P_TYPE& t){
+                return project_on_quadratic(s.a2, s.a1, s.a0, q, d, t); });
+
+        scan(cubics_, _kind::cubic, *p, min_dist, point_projection.parameter, 
+            best, best_index, 
+            [this](const _cubic& s){ return poly3d_solve_for(s.parametric, static_cast<P_TYPE>(1)); },
+            [this, &scratch](const _cubic& s, const ppl::vertex<P_TYPE, DIM>& q, P_TYPE& d, P_TYPE& t){
+                return project_on_curve(s.parametric, s.deriv, s.poly, q, d, t, scratch); });
+
+        point_projection.index = best_index;
+        const P_TYPE& t = point_projection.parameter;
+        switch(best.kind){
+            case _kind::line:{
+                const _line& s = lines_.segments[best.pos];
+                point_projection.closest = s.a1*t + s.a0;
+                point_projection.tan = s.a1;
+                break;
+            }
+            case _kind::quadratic:{
+                const _quadratic& s = quadratics_.segments[best.pos];
+                point_projection.closest = (s.a2*t + s.a1)*t + s.a0;
+                point_projection.tan = 2*t*s.a2 + s.a1;
+                break;
+            }
+            case _kind::cubic:{
+                const _cubic& s = cubics_.segments[best.pos];
+                point_projection.closest = poly3d_solve_for(s.parametric, t);
+                point_projection.tan = deriv3d_solve_for(s.deriv, t);
+                break;
+            }
+        }
+        point_projection.dist = point_projection.closest.dist(*p);
+        return point_projection;
+    }
+
+
+    uint64_t segments(void) const { return segments_; }
+
+    uint64_t lines(void) const { return lines_.segments.size(); }
+
+    uint64_t quadratics(void) const { return quadratics_.segments.size(); }
+
+    uint64_t cubics(void) const { return cubics_.segments.size(); }
+
+    std::size_t footprint(void) const {
+        return lines_.footprint() + quadratics_.footprint() + cubics_.footprint();
+    }
+
+};
+
+} // namespace ppl
+
+#endif //  PPL_SEGMENT_PATH_HPP
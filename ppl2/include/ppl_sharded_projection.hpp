@@ -0,0 +1,325 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_SHARDED_PROJECTION_HPP
+#define PPL_SHARDED_PROJECTION_HPP
+
+
+#if defined PPL_PROJECTION_SERVICE && defined PPL_CONCURRENCY
+
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <signal.h>
+#include <dirent.h>
+
+
+namespace ppl
+{
+
+/*
+ * A path split into shards of contiguous curves, each one built and
+ * served by a worker process of its own, so that no process holds more
+ * than a shard of the coefficients. The coordinator scatters a query to
+ * the shards, gathers their projections and keeps the closest one, its
+ * curve index referring to the whole path.
+ *
+ * Each shard is bounded by the box of its control points, which holds its
+ * curves. A query goes to the shard whose box is nearest first, then only
+ * to the shards whose box is closer than the best distance found so far.
+ *
+ * The workers are forked by the constructor and terminated by the destructor
+ * or along with the coordinator. A forked worker builds its shard and serves
+ * it, which only a single-threaded process may fork, so the coordinator
+ * must be constructed while its process runs no other thread, which is
+ * asserted. A coordinator is used by one thread at a time.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class sharded_projection
+{
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::sharded_projection can only be with floating-point types!\n");
+
+    typedef ppl::service_wire<P_TYPE, DIM> wire;
+
+    struct _shard{
+        std::string socket;
+        pid_t worker{-1};
+        std::unique_ptr<ppl::projection_client<P_TYPE, DIM>> client;
+        uint64_t stride{0};   // the index of the first curve of the shard in the path
+        ppl::vertex<P_TYPE, DIM> low, high;
+
+        // the points of a batch sent to the shard, and their projections
+        std::vector<ppl::vertex<P_TYPE, DIM>> queries;
+        std::vector<uint64_t> owners;
+        std::vector<ppl::projection<P_TYPE, DIM>> found;
+    };
+
+    std::vector<_shard> shards;
+    std::vector<P_TYPE> gaps;
+    std::vector<std::size_t> nearest;
+
+    uint64_t _sent{0}, _skipped{0};
+
+
+    // the distance from 'p' to the box of the shard, 0 inside it
+    PPL_FUNC_DECL P_TYPE gap(const _shard& _s, const ppl::vertex<P_TYPE, DIM>& p) const {
+        const ppl::vertex<P_TYPE, DIM> _closest{ppl::fuse([](auto c, auto l, auto h){ 
+                    return std::min(std::max(c, l), h); }, p, _s.low, _s.high)};
+        return p.dist(_closest);
+    }
+
+    // the number of threads of the process, 0 if it can't be told
+    static std::size_t threads(void)
+    {
+        DIR* const _dir{opendir("/proc/self/task")};
+        if(!_dir)
+            return 0;
+        std::size_t _count{0};
+        while(const dirent* const _entry = readdir(_dir))
+            _count += _entry->d_name[0] != '.';
+        closedir(_dir);
+        return _count;
+    }
+
+    // forks the worker serving the '_size' control points of the shard '_s'
+    void spawn(_shard& _s, ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _size, 
+                const std::chrono::microseconds& _window)
+    {
+        signed ready[2];
+        if(pipe2(ready, O_CLOEXEC) < 0)
+            throw std::runtime_error("could not create the pipe of shard <"+_s.socket+">\n");
+
+        _s.worker = fork();
+        if(_s.worker == 0){
+            close(ready[0]);
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+            char ok{0};
+            try{
+                ppl::point_projection<P_TYPE, DIM> path(_points, _size);
+                ppl::projection_server<P_TYPE, DIM> server(_s.socket, path, _window);
+                ok = 1;
+                if(write(ready[1], &ok, 1) < 0)
+                    _exit(1);
+                close(ready[1]);
+                server.run();
+            }catch(...){
+                if(!ok && write(ready[1], &ok, 1) < 0){}
+                _exit(1);
+            }
+            _exit(0);
+        }
+
+        close(ready[1]);
+        char ok{0};
+        if(_s.worker < 0 || read(ready[0], &ok, 1) != 1 || !ok){
+            close(ready[0]);
+            throw std::runtime_error("could not start the worker of shard <"+_s.socket+">\n");
+        }
+        close(ready[0]);
+    }
+
+    // sends the queries gathered for each shard, and waits for all the answers
+    void scatter(void)
+    {
+        for(_shard& s : shards)
+            if(!s.queries.empty()){
+                s.client->post(s.queries.data(), s.queries.size());
+                _sent += s.queries.size();
+            }
+        for(_shard& s : shards)
+            if(!s.queries.empty()){
+                s.found.resize(s.queries.size());
+                s.client->collect(s.found.data(), s.found.size());
+            }
+    }
+
+    void __localize(ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _size, 
+                ppl::projection<P_TYPE, DIM> * const _answers)
+    {
+        // rejected before any shard is asked, so that no answer is left unread
+        if(!wire::finite(_points, _size))
+            throw std::invalid_argument("a query point isn't finite!\n");
+
+        const std::size_t _shards{shards.size()};
+        gaps.resize(_size*_shards);
+        nearest.resize(_size);
+        for(uint64_t i{0}; i < _size; ++i){
+            for(std::size_t s{0}; s < _shards; ++s)
+                gaps[i*_shards + s] = gap(shards[s], _points[i]);
+            nearest[i] = std::min_element(gaps.begin() + i*_shards, 
+                        gaps.begin() + (i+1)*_shards) - (gaps.begin() + i*_shards);
+        }
+
+        // each point to the shard nearest to it
+        for(_shard& s : shards){
+            s.queries.clear();
+            s.owners.clear();
+        }
+        for(uint64_t i{0}; i < _size; ++i){
+            shards[nearest[i]].queries.push_back(_points[i]);
+            shards[nearest[i]].owners.push_back(i);
+        }
+        scatter();
+        for(_shard& s : shards)
+            for(std::size_t k{0}; k < s.queries.size(); ++k){
+                _answers[s.owners[k]] = s.found[k];
+                _answers[s.owners[k]].index += s.stride;
+            }
+
+        // then to the shards its best projection doesn't rule out
+        for(_shard& s : shards){
+            s.queries.clear();
+            s.owners.clear();
+        }
+        for(uint64_t i{0}; i < _size; ++i)
+            for(std::size_t s{0}; s < _shards; ++s){
+                const P_TYPE _gap{gaps[i*_shards + s]};
+                if(s == nearest[i])
+                    continue;
+                if(_gap > 0 && _gap*_gap >= _answers[i].dist*_answers[i].dist){
+                    ++_skipped;
+                    continue;
+                }
+                shards[s].queries.push_back(_points[i]);
+                shards[s].owners.push_back(i);
+            }
+        scatter();
+        for(_shard& s : shards)
+            for(std::size_t k{0}; k < s.queries.size(); ++k)
+                if(s.found[k].dist < _answers[s.owners[k]].dist){
+                    _answers[s.owners[k]] = s.found[k];
+                    _answers[s.owners[k]].index += s.stride;
+                }
+    }
+
+    void cleanUp(void)
+    {
+        for(_shard& s : shards){
+            s.client.reset();
+            if(s.worker > 0){
+                kill(s.worker, SIGTERM);
+                waitpid(s.worker, nullptr, 0);
+                unlink(s.socket.c_str());
+            }
+        }
+        shards.clear();
+    }
+
+public:
+
+    /*
+     * Splits the path of '_size' control points into '_shards' shards of
+     * about as many curves, served on the sockets '_socket.0', '_socket.1'
+     * and so on. The workers answer at once, unless a coalescing '_window'
+     * is given, see ppl::projection_server.
+     */
+    sharded_projection(const std::string& _socket, 
+            ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _size, 
+            const std::size_t& _shards, 
+            const std::chrono::microseconds& _window = std::chrono::microseconds(0))
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                "incompatible number of control points!" );
+        ppl_assert__(_shards > 0, "no shards!");
+        ppl_assert__(threads() <= 1, "a sharded projection constructed by a multithreaded process!");
+
+        const uint64_t _curves{(_size-1)/ppl::cubic};
+        const uint64_t _shardN{std::min<uint64_t>(_shards, _curves)};
+        shards.resize(_shardN);
+
+        try{
+            for(uint64_t i{0}; i < _shardN; ++i){
+                _shard& s{shards[i]};
+                s.socket = _socket + "." + std::to_string(i);
+                s.stride = _curves/_shardN*i;
+                const uint64_t _last{i+1 == _shardN? _curves : _curves/_shardN*(i+1)};
+                const uint64_t _count{(_last - s.stride)*ppl::cubic + 1};
+                const ppl::vertex<P_TYPE, DIM>* const _shard_points{_points + s.stride*ppl::cubic};
+
+                s.low = s.high = _shard_points[0];
+                for(uint64_t j{1}; j < _count; ++j){
+                    s.low = ppl::fuse([](auto l, auto c){ return std::min(l, c); }, s.low, _shard_points[j]);
+                    s.high = ppl::fuse([](auto h, auto c){ return std::max(h, c); }, s.high, _shard_points[j]);
+                }
+                spawn(s, _shard_points, _count, _window);
+            }
+
+            // once all are forked, so that no worker holds the connections of the others
+            for(_shard& s : shards)
+                s.client = std::make_unique<ppl::projection_client<P_TYPE, DIM>>(s.socket);
+        }catch(...){
+            cleanUp();
+            throw;
+        }
+    }
+
+    sharded_projection(const sharded_projection&) = delete;
+    sharded_projection& operator=(const sharded_projection&) = delete;
+
+    virtual ~sharded_projection(){ cleanUp(); }
+
+    // projects '_size' points, each batch of points is scattered to the shards at once
+    void localize(ppl::vertex<P_TYPE, DIM> const * const _points, const uint64_t& _size, 
+                ppl::projection<P_TYPE, DIM> * const _answers)
+    {
+        for(uint64_t _first{0}; _first < _size; _first += wire::batch)
+            __localize(_points + _first, std::min<uint64_t>(wire::batch, _size - _first), 
+                        _answers + _first);
+    }
+
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p)
+    {
+        ppl::projection<P_TYPE, DIM> answer;
+        __localize(p, 1, &answer);
+        return answer;
+    }
+
+    std::size_t shard_count(void) const { return shards.size(); }
+
+    // points sent to the shards so far, and skipped thanks to their boxes
+    uint64_t sent(void) const { return _sent; }
+    uint64_t skipped(void) const { return _skipped; }
+};
+
+
+} // namespace ppl
+
+
+#endif   // PPL_PROJECTION_SERVICE && PPL_CONCURRENCY
+
+
+#endif   //  PPL_SHARDED_PROJECTION_HPP
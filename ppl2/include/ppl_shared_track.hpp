@@ -0,0 +1,382 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_SHARED_TRACK_HPP
+#define PPL_SHARED_TRACK_HPP
+
+
+#ifdef PPL_EXTERNAL_TRACK_LOADING
+
+#if !defined(__linux__) || !__has_include(<sys/mman.h>)
+#error "shared tracks are only supported on Linux!"
+#endif
+
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+
+
+namespace ppl
+{
+
+/*
+ * A precomputed track in a named POSIX shared memory segment. One process
+ * publishes the track, building it straight into the segment, and any
+ * number of processes attach it read-only: the control points and the
+ * coefficients are queried in place, with no copy and no build.
+ *
+ * The arrays are located by their offsets from the start of the segment,
+ * so the segment can be mapped at any address. Each publication goes to a
+ * segment of its own, '_name.<generation>', and a small directory segment
+ * '_name' holds the generation in use. Publishing a new generation swaps
+ * the directory atomically and unlinks the previous segment, whose
+ * mappings stay valid until their readers let them go.
+ *
+ * Layout "little-endian, as written by the host":
+ *
+ *   _header
+ *   vertex    points[curves*3+1]     // at header.points, and so on
+ *   poly1d    polys[curves]
+ *   poly3d    parametric[curves]
+ *   deriv3d   deriv[curves]
+ *
+ * One process publishes a name at a time. Names follow shm_open(), a
+ * leading '/' and no other.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class shared_track
+{
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::shared_track can only be with floating-point types!\n");
+	static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		"the generation of a shared track has to be address-free!\n");
+
+public:
+
+    typedef std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> snapshot;
+
+    static constexpr char magic[4]={'P', 'P', 'L', 'S'};
+    static constexpr uint32_t version{1};
+
+private:
+
+    struct _header{
+        char magic[4];
+        uint32_t version;
+        uint32_t dim;
+        uint32_t vertex_bytes;   // the layouts of ppl::vertex and of the coefficients
+        uint32_t coeff_bytes;    // the segment was built with
+        uint32_t reserved;
+        uint64_t generation;
+        uint64_t curves;
+        uint64_t points, polys, parametric, deriv;   // offsets from the start of the segment
+    };
+
+    struct _directory{
+        char magic[4];
+        uint32_t version;
+        std::atomic<uint64_t> generation;   // 0 until the first publication
+    };
+
+    // a shared memory object mapped as a whole, the mapping outlives the descriptor
+    struct _mapping{
+        void* addr{MAP_FAILED};
+        std::size_t length{0};
+
+        // the object is resized to '_length' bytes when it's given
+        _mapping(const std::string& _seg, const signed& _flags, const std::size_t& _length = 0)
+        {
+            const signed f_descriptor{shm_open(_seg.c_str(), _flags, 0644)};
+            if(f_descriptor < 0)
+                throw std::runtime_error("could not open shared memory <"+_seg+">\n");
+
+            struct stat buf;
+            if(_length > 0 ? ftruncate(f_descriptor, _length) < 0 : fstat(f_descriptor, &buf) < 0){
+                close(f_descriptor);
+                throw std::runtime_error("not able to size shared memory <"+_seg+">\n");
+            }
+            length = _length > 0 ? _length : buf.st_size;
+
+            const signed _prot{(_flags & O_ACCMODE) == O_RDWR ? PROT_READ | PROT_WRITE : PROT_READ};
+            addr = length > 0 ? mmap(NULL, length, _prot, MAP_SHARED, f_descriptor, 0) : MAP_FAILED;
+            close(f_descriptor);
+            if(addr == MAP_FAILED)
+                throw std::runtime_error("an exception occurred while mapping shared memory <"+_seg+">\n");
+        }
+
+        _mapping(const _mapping&) = delete;
+        _mapping& operator=(const _mapping&) = delete;
+
+        ~_mapping(){ munmap(addr, length); }
+
+        uint8_t* base(void) const { return static_cast<uint8_t*>(addr); }
+    };
+
+    // a generation attached by this process, the path views the mapping
+    struct _attached{
+        _mapping segment;
+        ppl::cubic_path<P_TYPE, DIM> path;
+
+        explicit _attached(const std::string& _seg): segment(_seg, O_RDONLY) {}
+    };
+
+    std::string name;
+    std::unique_ptr<_mapping> directory;
+    std::atomic<uint64_t> _generation{0};
+    snapshot _track;
+
+
+    static constexpr uint32_t coeff_bytes{sizeof(ppl::poly1d<P_TYPE>) 
+                + sizeof(ppl::poly3d<P_TYPE, DIM>) + sizeof(ppl::deriv3d<P_TYPE, DIM>)};
+
+    static void check_name(const std::string& _name){
+        if(_name.size() < 2 || _name[0] != '/' || _name.find('/', 1) != std::string::npos)
+            throw std::invalid_argument("invalid name of shared memory <"+_name+">\n");
+    }
+
+    static std::string segment_name(const std::string& _name, const uint64_t& _gen){
+        return _name + "." + std::to_string(_gen);
+    }
+
+    // the header, and the arrays each starting on their own cache line
+    static std::size_t segment_bytes(const uint64_t& _curves){
+        return sizeof(_header) + ppl::alloc_alignment*5 
+            + ppl::cubic_path<P_TYPE, DIM>::bytes_per_curve()*_curves + sizeof(ppl::vertex<P_TYPE, DIM>);
+    }
+
+    static _directory* directory_of(const _mapping& _dir, const std::string& _name){
+        _directory* dir{reinterpret_cast<_directory*>(_dir.addr)};
+        if(_dir.length < sizeof(_directory) || memcmp(dir->magic, magic, sizeof(magic)) != 0 
+                || dir->version != version)
+            throw std::invalid_argument("not a shared track <"+_name+">\n");
+        return dir;
+    }
+
+    void validate(const _mapping& _seg, const std::string& _name, const uint64_t& _gen) const
+    {
+        if(_seg.length < sizeof(_header))
+            throw std::invalid_argument("not a shared track, the segment is too short <"+_name+">\n");
+        const _header* h{reinterpret_cast<const _header*>(_seg.addr)};
+        if(memcmp(h->magic, magic, sizeof(magic)) != 0)
+            throw std::invalid_argument("not a shared track, wrong magic number <"+_name+">\n");
+        if(h->version != version)
+            throw std::invalid_argument("unsupported version of shared track: " 
+                        + std::to_string(h->version) + " <"+_name+">\n");
+        if(h->dim != DIM || h->vertex_bytes != sizeof(ppl::vertex<P_TYPE, DIM>) 
+                || h->coeff_bytes != coeff_bytes)
+            throw std::invalid_argument("the shared track holds other vertices <"+_name+">\n");
+        if(h->generation != _gen || h->curves == 0)
+            throw std::invalid_argument("corrupted shared track <"+_name+">\n");
+        // the sizes of the arrays below can't wrap past this
+        if(h->curves > _seg.length/ppl::cubic_path<P_TYPE, DIM>::bytes_per_curve())
+            throw std::out_of_range("truncated shared track <"+_name+">\n");
+
+        auto within = [&](const uint64_t& _offset, const std::size_t& _bytes){
+            return _offset % ppl::alloc_alignment == 0 && _offset <= _seg.length 
+                && _bytes <= _seg.length - _offset; };
+        if(!within(h->points, sizeof(ppl::vertex<P_TYPE, DIM>)*(h->curves*ppl::cubic + 1))
+                || !within(h->polys, sizeof(ppl::poly1d<P_TYPE>)*h->curves)
+                || !within(h->parametric, sizeof(ppl::poly3d<P_TYPE, DIM>)*h->curves)
+                || !within(h->deriv, sizeof(ppl::deriv3d<P_TYPE, DIM>)*h->curves))
+            throw std::out_of_range("truncated shared track <"+_name+">\n");
+    }
+
+    // attaches the generation in use, retrying if it's replaced meanwhile
+    void attach(void)
+    {
+        const _directory* dir{reinterpret_cast<const _directory*>(directory->addr)};
+        for(;;){
+            const uint64_t _gen{dir->generation.load(std::memory_order_acquire)};
+            if(_gen == 0)
+                throw std::runtime_error("nothing was published to the shared track <"+name+">\n");
+
+            std::shared_ptr<_attached> _attach;
+            try{
+                _attach = std::make_shared<_attached>(segment_name(name, _gen));
+            }catch(const std::runtime_error&){
+                // unlinked by a newer publication
+                if(dir->generation.load(std::memory_order_acquire) != _gen)
+                    continue;
+                throw;
+            }
+            validate(_attach->segment, name, _gen);
+
+            const _header* h{reinterpret_cast<const _header*>(_attach->segment.addr)};
+            const uint8_t* const base{_attach->segment.base()};
+            _attach->path.view(typename ppl::cubic_path<P_TYPE, DIM>::arrays{
+                    reinterpret_cast<const ppl::vertex<P_TYPE, DIM>*>(base + h->points),
+                    reinterpret_cast<const ppl::poly1d<P_TYPE>*>(base + h->polys),
+                    reinterpret_cast<const ppl::poly3d<P_TYPE, DIM>*>(base + h->parametric),
+                    reinterpret_cast<const ppl::deriv3d<P_TYPE, DIM>*>(base + h->deriv),
+                    h->curves});
+
+            std::atomic_store(&_track, snapshot(_attach, &_attach->path));
+            _generation.store(_gen, std::memory_order_release);
+            return;
+        }
+    }
+
+public:
+
+    // attaches the generation of '_name' in use
+    explicit shared_track(const std::string& _name): name{_name}
+    {
+        check_name(name);
+        directory.reset(new _mapping(name, O_RDONLY));
+        directory_of(*directory, name);
+        attach();
+    }
+
+    shared_track(const shared_track&) = delete;
+    shared_track& operator=(const shared_track&) = delete;
+
+    /*
+     * The attached track, a view of the segment valid for as long as the
+     * caller holds it, even after a refresh(). It can be published to a
+     * ppl::track_handle as is.
+     */
+    snapshot acquire(void) const {
+        return std::atomic_load(&_track);
+    }
+
+    uint64_t generation(void) const { return _generation.load(std::memory_order_acquire); }
+
+    // the generation in use by the publisher
+    uint64_t latest(void) const {
+        return reinterpret_cast<const _directory*>(directory->addr)->generation.load(std::memory_order_acquire);
+    }
+
+    bool stale(void) const { return latest() != generation(); }
+
+    /*
+     * Attaches the generation in use if a newer one was published. Queries
+     * may run meanwhile, on the generation they acquired.
+     */
+    bool refresh(void){
+        if(!stale())
+            return false;
+        attach();
+        return true;
+    }
+
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p) const {
+        return acquire()->closest_point(p);
+    }
+
+    /*
+     * Builds the path of '_size' control points into a new generation of
+     * '_name' and makes it the one in use. The coefficients are computed in
+     * the segment itself. Returns the published generation.
+     */
+    static uint64_t publish(const std::string& _name, 
+            const ppl::vertex<P_TYPE, DIM>* const _points, const uint64_t& _size)
+    {
+        check_name(_name);
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+
+        _mapping _dir(_name, O_CREAT | O_RDWR, sizeof(_directory));
+        _directory* dir{reinterpret_cast<_directory*>(_dir.addr)};
+        if(dir->version == 0){
+            memcpy(dir->magic, magic, sizeof(magic));
+            dir->version = version;
+        }
+        directory_of(_dir, _name);
+
+        const uint64_t _gen{dir->generation.load(std::memory_order_acquire) + 1};
+        const std::string _seg{segment_name(_name, _gen)};
+        const uint64_t _curves{(_size-1)/ppl::cubic};
+
+        // left over by a publication which failed
+        shm_unlink(_seg.c_str());
+        try{
+            _mapping segment(_seg, O_CREAT | O_EXCL | O_RDWR, segment_bytes(_curves));
+            uint8_t* const base{segment.base()};
+
+            std::pmr::monotonic_buffer_resource _buffer(base + sizeof(_header), 
+                        segment.length - sizeof(_header), std::pmr::null_memory_resource());
+            ppl::cubic_path<P_TYPE, DIM> path(&_buffer);
+            path.routing(_points, _size);
+
+            const typename ppl::cubic_path<P_TYPE, DIM>::arrays _arrays{path.data()};
+            _header* h{reinterpret_cast<_header*>(base)};
+            memcpy(h->magic, magic, sizeof(magic));
+            h->version = version;
+            h->dim = DIM;
+            h->vertex_bytes = sizeof(ppl::vertex<P_TYPE, DIM>);
+            h->coeff_bytes = coeff_bytes;
+            h->generation = _gen;
+            h->curves = _arrays.curves;
+            h->points = reinterpret_cast<const uint8_t*>(_arrays.points) - base;
+            h->polys = reinterpret_cast<const uint8_t*>(_arrays.polys) - base;
+            h->parametric = reinterpret_cast<const uint8_t*>(_arrays.parametric) - base;
+            h->deriv = reinterpret_cast<const uint8_t*>(_arrays.deriv) - base;
+        }catch(...){
+            shm_unlink(_seg.c_str());
+            throw;
+        }
+
+        dir->generation.store(_gen, std::memory_order_release);
+        if(_gen > 1)
+            shm_unlink(segment_name(_name, _gen-1).c_str());
+        return _gen;
+    }
+
+    // unlinks '_name' and its generation in use, processes attached to it keep their mappings
+    static void remove(const std::string& _name)
+    {
+        check_name(_name);
+        uint64_t _gen{0};
+        try{
+            _mapping _dir(_name, O_RDONLY);
+            _gen = directory_of(_dir, _name)->generation.load(std::memory_order_acquire);
+        }catch(const std::exception&){}
+
+        if(_gen > 0)
+            shm_unlink(segment_name(_name, _gen).c_str());
+        shm_unlink(_name.c_str());
+    }
+};
+
+
+} // namespace ppl
+
+
+#endif   // PPL_EXTERNAL_TRACK_LOADING
+
+
+#endif   //  PPL_SHARED_TRACK_HPP
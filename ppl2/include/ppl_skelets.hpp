@@ -45,12 +45,25 @@ namespace ppl
 {
 
 
-template<typename P_TYPE> struct projection{
-    ppl::vertex<P_TYPE> closest;
+// tag selecting paths which reference the caller's control points instead of copying them
+struct borrow_points_t{ explicit borrow_points_t() = default; };
+constexpr borrow_points_t borrow_points{};
+
+// tag selecting paths which keep only control points and recompute the coefficients on every query
+struct lean_coeffs_t{ explicit lean_coeffs_t() = default; };
+constexpr lean_coeffs_t lean_coeffs{};
+
+// tag selecting paths which compute the coefficients of a tile of curves when a query first reaches it
+struct lazy_coeffs_t{ explicit lazy_coeffs_t() = default; };
+constexpr lazy_coeffs_t lazy_coeffs{};
+
+
+template<typename P_TYPE, std::size_t DIM = 3> struct projection{
+    ppl::vertex<P_TYPE, DIM> closest;
     uint64_t index;
     P_TYPE dist;
     P_TYPE parameter;
-    ppl::vertex<P_TYPE> tan;
+    ppl::vertex<P_TYPE, DIM> tan;
 };
 
 template<typename P_TYPE>
@@ -61,75 +74,36 @@ struct poly1d
     P_TYPE coeffs[ppl::quintic_Coeffs];  
 };
 
-template<typename P_TYPE>
-static const std::function<const ppl::vertex<P_TYPE>(const ppl::vertex<P_TYPE>* const)> 
-    parametric_coeffs[ppl::cubic_points]={ 
-        [](const ppl::vertex<P_TYPE>* const controlPs) -> const ppl::vertex<P_TYPE> {return   3*(controlPs[1]-controlPs[2]) + controlPs[3]-controlPs[0]; },
-        [](const ppl::vertex<P_TYPE>* const controlPs) -> const ppl::vertex<P_TYPE> {return   3*(controlPs[0]+controlPs[2])-6*controlPs[1]; },
-        [](const ppl::vertex<P_TYPE>* const controlPs) -> const ppl::vertex<P_TYPE> {return   3*(controlPs[1]-controlPs[0]); },
-        [](const ppl::vertex<P_TYPE>* const controlPs) -> const ppl::vertex<P_TYPE> {return   *controlPs; } 
-    };
-
-template<typename P_TYPE> struct poly3d {
+// a cubic polynomial of vertices, "3d" is the degree, the vertices have DIM coordinates
+template<typename P_TYPE, std::size_t DIM = 3> struct poly3d {
     std::size_t d{ppl::cubic};
-    ppl::vertex<P_TYPE> coeffs[ppl::cubic_Coeffs]; 
+    ppl::vertex<P_TYPE, DIM> coeffs[ppl::cubic_Coeffs]; 
 };
 
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM = 3>
 struct deriv3d
 {   std::size_t d{ppl::quadratic};
-    ppl::vertex<P_TYPE> coeffs[ppl::quadratic_Coeffs]; 
+    ppl::vertex<P_TYPE, DIM> coeffs[ppl::quadratic_Coeffs]; 
 };
 
 
-template<typename P_TYPE, typename DEF_TYPE> 
-struct default_precision_polys
-{
-    default_precision_polys(DEF_TYPE const * const coeffs)
-    {
-        std::size_t i{0};
-        if(std::is_same<P_TYPE, DEF_TYPE>::value)
-            memcpy(poly[0].coeffs, coeffs, 
-                sizeof(P_TYPE) * ppl::quintic_Coeffs);
-        else
-            for(;i<ppl::quintic_Coeffs;++i)
-                poly[0].coeffs[i] = static_cast<P_TYPE>(coeffs[i]);
-
-        poly[1].d = ppl::quartic;
-        poly[1].coeffs[1] = 5;
-
-        for (i=1; i < ppl::quartic; ++i) // first derivative
-                    poly[1].coeffs[i + 1] = (ppl::quintic - i) * poly[0].coeffs[i];
-        poly[1].coeffs[5] = poly[0].coeffs[ppl::quartic];
-    }
-    ppl::poly1d<P_TYPE> poly[ppl::quadratic];
-};
-
-template<typename P_TYPE> 
-struct objPoly
-{
-    objPoly(){
-        poly.coeffs[0] = 1;
-    }
-    ppl::poly1d<P_TYPE> poly;
-};
-
 template <typename P_TYPE> 
 PPL_FUNC_DECL signed char __sign(P_TYPE val) {
     return (P_TYPE(0) < val) - (val < P_TYPE(0));
 }
 
 
+// a quintic has five real roots at most, and __split reports one per isolating interval
 template<typename P_TYPE>
 struct real_roots
 {
     std::size_t num{0};
-    P_TYPE zeros[ppl::quintic*20];
+    P_TYPE zeros[ppl::quintic];
 
     PPL_FUNC_DECL void push(P_TYPE val){
-        this->zeros[this->num] = val;
-        this->num++;
+        if(this->num < ppl::quintic)
+            this->zeros[this->num++] = val;
     }
 
     PPL_FUNC_DECL void clear(void){
@@ -138,6 +112,41 @@ struct real_roots
 };
 
 
+// the number of halvings of [0, 1] before an interval is narrower than 'tol'
+constexpr uint32_t split_depth(ppl::LD tol){
+    uint32_t depth{0};
+    for(ppl::LD width{1}; width > tol; width /= 2)
+        ++depth;
+    return depth;
+}
+
+/*
+ * The working memory of the projection on a single curve. A query makes
+ * one and reuses it for every curve it visits, every member is written
+ * before it is read.
+ */
+template<typename P_TYPE, typename ALTERS_TYPE>
+struct solver_scratch
+{
+    ALTERS_TYPE obj[ppl::quintic_Coeffs];   // the monic quintic of the query point, once it has a root
+    ppl::real_roots<P_TYPE> roots;
+
+    /*
+     * The intervals left to be split by __split, depth first. An interval
+     * is split at most split_depth(TOLERANCE) times, so no more than one
+     * interval per depth is ever pending "one more for the tolerance
+     * rounded to P_TYPE".
+     */
+    struct interval{
+        ALTERS_TYPE a, b;
+        uint32_t depth;
+        uint8_t alters;
+    };
+    interval pending[ppl::split_depth(
+        ppl::TOLERANCE<ppl::eps? ppl::eps : ppl::TOLERANCE) + 2];
+};
+
+
 PPL_FUNC_DECL uint64_t prec_call(CONST ppl::LD& val)
 {
 	if(val>=1)
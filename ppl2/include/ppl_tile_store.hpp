@@ -0,0 +1,625 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_TILE_STORE_HPP
+#define PPL_TILE_STORE_HPP
+
+
+#ifdef PPL_EXTERNAL_TRACK_LOADING
+
+#if !defined(__linux__) || !__has_include(<sys/mman.h>)
+#error "out-of-core tracks are only supported on Linux!"
+#endif
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+
+namespace ppl
+{
+
+/*
+ * A track too large for the memory, kept in a file of tiles and paged in
+ * on demand. Consecutive curves are grouped in tiles, cut when a tile
+ * reaches a number of curves or a spatial extent, so that every tile covers
+ * a compact area. Each tile is stored as a subpath of its own "3k+1 control
+ * points" at a page aligned offset, and a directory at the head of the file
+ * keeps the sphere holding each tile.
+ *
+ * Layout "little-endian, as written by the host":
+ *
+ *   _header
+ *   _tile     directory[tiles]
+ *   vertex    points[]          // of each tile, at directory[t].offset
+ *
+ * The file is mapped, and a tile a query reaches becomes a lazy
+ * ppl::cubic_path borrowing its control points from the mapping. Resident
+ * tiles are kept up to a budget of bytes and the least recently used are
+ * dropped beyond it. A query pages in only the tiles its search sphere
+ * touches. The motion of the queries of a caller, kept in a cursor of its
+ * own, drives a read-ahead of the tiles in front of them, see prefetch().
+ *
+ * The spheres of the tiles are indexed by a tree of boxes built when the
+ * file is mapped, so that a query or a read-ahead only goes through the
+ * tiles near it, not through the whole directory.
+ *
+ * Queries may run concurrently. Curve indices of the projections refer to
+ * the whole track.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class tile_store
+{
+
+public:
+
+    static constexpr char magic[4]={'P', 'P', 'L', 'T'};
+    static constexpr uint32_t version{1};
+
+    // the offsets of the tiles are aligned to pages of this size
+    static constexpr uint64_t page{4096};
+
+    /*
+     * The motion of the queries of one caller, e.g. a tracker, which drives
+     * the read-ahead in front of them. Each caller keeps a cursor of its
+     * own, so that concurrent trackers don't take the steps between each
+     * other's queries for a motion. A cursor is used by one thread at a time.
+     */
+    struct cursor{
+        ppl::vertex<P_TYPE, DIM> last;
+        bool moving{0};
+    };
+
+private:
+
+    struct _header{
+        char magic[4];
+        uint32_t version;
+        uint32_t dim;
+        uint32_t vertex_bytes;   // the layout of ppl::vertex the file was written with
+        uint64_t curves;
+        uint64_t tiles;
+    };
+
+    struct _tile{
+        uint64_t first;    // the index of the first curve of the tile in the track
+        uint64_t curves;
+        uint64_t offset;   // of the control points from the start of the file
+        double radius;
+        double centre[DIM];
+    };
+
+    // a box of the index, over the tiles order[first, first+count) if it's a leaf
+    struct _node{
+        ppl::vertex<P_TYPE, DIM> low, high;
+        uint64_t first;   // of its tiles if it's a leaf, of its two children otherwise
+        uint64_t count;   // 0 if it isn't a leaf
+    };
+
+    // tiles of a leaf at most, and room of a walk reserved at once
+    static constexpr uint64_t LEAF{4};
+    static constexpr std::size_t WALK{64};
+
+    struct _resident{
+        std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> path;
+        std::list<uint64_t>::iterator used;
+        std::size_t bytes;
+    };
+
+    signed f_descriptor{-1};
+    void* addr{MAP_FAILED};
+    std::size_t length{0};
+
+    _header header{};
+    const _tile* directory{nullptr};
+
+    std::vector<_node> nodes;      // the root first
+    std::vector<uint64_t> order;   // the tiles, those of a leaf side by side
+
+    std::size_t budget;
+    std::size_t _resident_bytes{0};
+    std::unordered_map<uint64_t, _resident> resident;
+    std::list<uint64_t> lru;   // most recently used first
+    std::vector<uint8_t> advised;
+
+    std::atomic<uint32_t> lookahead{8};
+
+    uint64_t _loads{0}, _evictions{0}, _prefetches{0};
+    mutable std::mutex _guard;
+
+
+    PPL_FUNC_DECL const ppl::vertex<P_TYPE, DIM>* points(const uint64_t& t) const {
+        return reinterpret_cast<const ppl::vertex<P_TYPE, DIM>*>(
+                    static_cast<const uint8_t*>(addr) + directory[t].offset);
+    }
+
+    PPL_FUNC_DECL std::size_t point_bytes(const uint64_t& t) const {
+        return sizeof(ppl::vertex<P_TYPE, DIM>)*(directory[t].curves*ppl::cubic + 1);
+    }
+
+    // the distance from 'p' to the sphere of the tile 't', negative inside it
+    PPL_FUNC_DECL P_TYPE gap(const uint64_t& t, const ppl::vertex<P_TYPE, DIM>& p) const {
+        const ppl::vertex<P_TYPE, DIM> centre{ppl::make_vertex<P_TYPE, DIM>([&](auto k){ 
+                    return static_cast<P_TYPE>(directory[t].centre[k]); })};
+        return p.dist(centre) - static_cast<P_TYPE>(directory[t].radius);
+    }
+
+    // the distance from 'p' to the box of the node 'n', 0 inside it
+    PPL_FUNC_DECL P_TYPE gap(const _node& n, const ppl::vertex<P_TYPE, DIM>& p) const {
+        const ppl::vertex<P_TYPE, DIM> _closest{ppl::fuse([](auto c, auto l, auto h){ 
+                    return std::min(std::max(c, l), h); }, p, n.low, n.high)};
+        return p.dist(_closest);
+    }
+
+    // the node over the tiles order[_first, _last), and the nodes below it
+    void index(const uint64_t& _n, const uint64_t& _first, const uint64_t& _last)
+    {
+        _node& n{nodes[_n]};
+        for(uint64_t i{_first}; i < _last; ++i){
+            const _tile& tile{directory[order[i]]};
+            const ppl::vertex<P_TYPE, DIM> centre{ppl::make_vertex<P_TYPE, DIM>([&](auto k){ 
+                        return static_cast<P_TYPE>(tile.centre[k]); })};
+            const ppl::vertex<P_TYPE, DIM> _low{centre - static_cast<P_TYPE>(tile.radius)};
+            const ppl::vertex<P_TYPE, DIM> _high{centre + static_cast<P_TYPE>(tile.radius)};
+            n.low = i == _first? _low : ppl::fuse([](auto l, auto c){ return std::min(l, c); }, n.low, _low);
+            n.high = i == _first? _high : ppl::fuse([](auto h, auto c){ return std::max(h, c); }, n.high, _high);
+        }
+        if(_last - _first <= LEAF){
+            n.first = _first;
+            n.count = _last - _first;
+            return;
+        }
+
+        // split at the median of the centres along the longest side of the box
+        const ppl::vertex<P_TYPE, DIM> _side{n.high - n.low};
+        std::size_t _axis{0};
+        ppl::for_each_coord<DIM>([&](auto k){ 
+            if(_side.template get<k>() > _side[_axis]) _axis = k; });
+        const uint64_t _middle{_first + (_last - _first)/2};
+        std::nth_element(order.begin() + _first, order.begin() + _middle, order.begin() + _last, 
+            [&](const uint64_t& a, const uint64_t& b){ 
+                return directory[a].centre[_axis] < directory[b].centre[_axis]; });
+
+        const uint64_t _children{nodes.size()};
+        n.first = _children;
+        n.count = 0;
+        nodes.resize(_children + 2);   // 'n' isn't used past this
+        index(_children, _first, _middle);
+        index(_children + 1, _middle, _last);
+    }
+
+    /*
+     * Calls 'f' with the tiles the box of a node and the sphere of the tile
+     * don't rule out, 'out(gap)' telling those ruled out, nearest first.
+     * Nodes and tiles wait in one heap by their gap to 'p', and 'out' is
+     * asked again once they're popped.
+     */
+    template<typename OUT, typename F>
+    void walk(const ppl::vertex<P_TYPE, DIM>& p, OUT&& out, F&& f) const
+    {
+        struct _reach{
+            P_TYPE gap;
+            uint64_t id;   // of a node, or of a tile
+            bool tile;
+            bool operator<(const _reach& r) const { return gap > r.gap; }
+        };
+
+        std::vector<_reach> _heap;
+        _heap.reserve(WALK);
+        _heap.push_back(_reach{gap(nodes[0], p), 0, 0});
+        while(!_heap.empty()){
+            std::pop_heap(_heap.begin(), _heap.end());
+            const _reach r{_heap.back()};
+            _heap.pop_back();
+            if(out(r.gap))
+                continue;
+            if(r.tile){
+                f(r.id);
+                continue;
+            }
+
+            const _node& n{nodes[r.id]};
+            auto push = [&](const _reach& _r){
+                if(!out(_r.gap)){
+                    _heap.push_back(_r);
+                    std::push_heap(_heap.begin(), _heap.end());
+                }
+            };
+            if(n.count > 0)
+                for(uint64_t i{n.first}; i < n.first + n.count; ++i)
+                    push(_reach{gap(order[i], p), order[i], 1});
+            else{
+                push(_reach{gap(nodes[n.first], p), n.first, 0});
+                push(_reach{gap(nodes[n.first + 1], p), n.first + 1, 0});
+            }
+        }
+    }
+
+    // the byte range of the tile 't' widened to pages, for madvise
+    void advise(const uint64_t& t, const signed& _advice) const {
+        const std::size_t _page = sysconf(_SC_PAGESIZE);
+        const std::size_t _first{directory[t].offset/_page*_page};
+        madvise(static_cast<uint8_t*>(addr) + _first, 
+                directory[t].offset + point_bytes(t) - _first, _advice);
+    }
+
+    // the path of the tile 't', paged in if it isn't resident, called under '_guard'
+    std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> acquire(const uint64_t& t)
+    {
+        auto found = resident.find(t);
+        if(found != resident.end()){
+            lru.splice(lru.begin(), lru, found->second.used);
+            return found->second.path;
+        }
+
+        std::shared_ptr<ppl::cubic_path<P_TYPE, DIM>> _path{
+                    std::make_shared<ppl::cubic_path<P_TYPE, DIM>>()};
+        _path->routing(points(t), directory[t].curves*ppl::cubic + 1, 
+                    ppl::borrow_points, ppl::lazy_coeffs);
+
+        lru.push_front(t);
+        const std::size_t bytes{_path->footprint() + point_bytes(t)};
+        resident.emplace(t, _resident{_path, lru.begin(), bytes});
+        _resident_bytes += bytes;
+        ++_loads;
+
+        // the tile just loaded stays, even if it's larger than the budget on its own
+        while(_resident_bytes > budget && lru.size() > 1)
+            evict(lru.back());
+
+        return _path;
+    }
+
+    // queries still holding the path of the tile finish with it, its pages are read again if needed
+    void evict(const uint64_t t)
+    {
+        auto found = resident.find(t);
+        _resident_bytes -= found->second.bytes;
+        lru.erase(found->second.used);
+        resident.erase(found);
+        advise(t, MADV_DONTNEED);
+        advised[t] = 0;
+        ++_evictions;
+    }
+
+    // read-ahead of the tiles within 'radius' of 'p' which aren't resident, the index is walked unlocked
+    void __prefetch(const ppl::vertex<P_TYPE, DIM>& p, const P_TYPE& radius)
+    {
+        uint64_t _near[WALK];
+        std::size_t _count{0};
+        auto flush = [&](void){
+            std::lock_guard<std::mutex> lock(_guard);
+            for(std::size_t i{0}; i < _count; ++i){
+                const uint64_t t{_near[i]};
+                if(!advised[t] && resident.find(t) == resident.end()){
+                    advise(t, MADV_WILLNEED);
+                    advised[t] = 1;
+                    ++_prefetches;
+                }
+            }
+            _count = 0;
+        };
+        walk(p, [&](const P_TYPE& _gap){ return !(_gap <= radius); }, 
+            [&](const uint64_t& t){
+                _near[_count++] = t;
+                if(_count == WALK)
+                    flush();
+            });
+        flush();
+    }
+
+    void validate(const std::string& _dir)
+    {
+        if(length < sizeof(_header))
+            throw std::invalid_argument("not a tile store, the file is too short <"+_dir+">\n");
+        memcpy(&header, addr, sizeof(_header));
+        if(memcmp(header.magic, magic, sizeof(magic)) != 0)
+            throw std::invalid_argument("not a tile store, wrong magic number <"+_dir+">\n");
+        if(header.version != version)
+            throw std::invalid_argument("unsupported version of tile store: " 
+                        + std::to_string(header.version) + " <"+_dir+">\n");
+        if(header.dim != DIM || header.vertex_bytes != sizeof(ppl::vertex<P_TYPE, DIM>))
+            throw std::invalid_argument("the tile store holds other vertices <"+_dir+">\n");
+        if(header.tiles == 0 || header.tiles > (length - sizeof(_header))/sizeof(_tile))
+            throw std::out_of_range("truncated tile store <"+_dir+">\n");
+
+        // the tiles follow each other, and their control points lie within the file
+        directory = reinterpret_cast<const _tile*>(static_cast<const uint8_t*>(addr) + sizeof(_header));
+        uint64_t _first{0};
+        for(uint64_t t{0}; t < header.tiles; ++t){
+            const _tile& tile{directory[t]};
+            if(tile.first != _first || tile.curves == 0 || tile.curves > header.curves - _first
+                    || tile.offset % page != 0 || tile.offset > length)
+                throw std::out_of_range("corrupted tile store <"+_dir+">\n");
+            // point_bytes(t) can't wrap past this
+            const uint64_t _room{(length - tile.offset)/sizeof(ppl::vertex<P_TYPE, DIM>)};
+            if(_room == 0 || tile.curves > (_room - 1)/ppl::cubic)
+                throw std::out_of_range("truncated tile store <"+_dir+">\n");
+            _first += tile.curves;
+        }
+        if(_first != header.curves)
+            throw std::out_of_range("corrupted tile store <"+_dir+">\n");
+    }
+
+    void cleanUp(void)
+    {
+        resident.clear();
+        lru.clear();
+        if(addr != MAP_FAILED)
+            munmap(addr, length);
+        if(f_descriptor >= 0)
+            close(f_descriptor);
+        addr = MAP_FAILED;
+        f_descriptor = -1;
+    }
+
+public:
+
+    /*
+     * Maps the tile store '_dir'. The resident tiles hold up to '_budget'
+     * bytes "their coefficients and the pages of their control points".
+     */
+    explicit tile_store(const std::string& _dir, const std::size_t& _budget = std::size_t(1)<<30)
+        : budget{_budget}
+    {
+        if(!does_exist(_dir))
+            throw std::invalid_argument("cannot find file <"+_dir+">\n" );
+
+        f_descriptor = open(_dir.c_str(), O_RDONLY);
+        if( f_descriptor < 0)
+            throw std::runtime_error("could not open file <"+_dir+">\n");
+
+        struct stat buf;
+        if(fstat(f_descriptor,&buf) < 0){
+            cleanUp();
+            throw std::runtime_error("not able to get file size <"+_dir+">\n");
+        }
+        length = buf.st_size;
+
+        addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, f_descriptor, 0);
+        if(addr == MAP_FAILED){
+            cleanUp();
+            throw std::runtime_error("an exception occurred while mapping the file <"+_dir+">\n");
+        }
+        // the queries jump between tiles, the read-ahead is left to prefetch()
+        madvise(addr, length, MADV_RANDOM);
+
+        try{
+            validate(_dir);
+        }catch(...){
+            cleanUp();
+            throw;
+        }
+        advised.assign(header.tiles, 0);
+
+        order.resize(header.tiles);
+        for(uint64_t t{0}; t < header.tiles; ++t)
+            order[t] = t;
+        nodes.reserve(2*header.tiles);
+        nodes.resize(1);
+        index(0, 0, header.tiles);
+    }
+
+    tile_store(const tile_store&) = delete;
+    tile_store& operator=(const tile_store&) = delete;
+
+    virtual ~tile_store(){ cleanUp(); }
+
+
+    /*
+     * Writes the path of '_size' control points to the tile store '_dir'. A
+     * tile is cut after '_tile_curves' curves, or before a curve which would
+     * make it wider than '_tile_extent' "the diagonal of its bounding box".
+     */
+    static void build(const std::string& _dir, 
+            const ppl::vertex<P_TYPE, DIM>* const _points, const uint64_t& _size, 
+            const uint64_t& _tile_curves = 4096, 
+            const P_TYPE& _tile_extent = std::numeric_limits<P_TYPE>::infinity())
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        ppl_assert__(_tile_curves > 0, "empty tiles!");
+
+        const uint64_t _curves{(_size-1)/ppl::cubic};
+        std::vector<_tile> _directory;
+
+        for(uint64_t i{0}; i < _curves; ){
+            _tile tile{};
+            tile.first = i;
+            ppl::vertex<P_TYPE, DIM> low{_points[i*ppl::cubic]}, high{low};
+            for(; i < _curves && tile.curves < _tile_curves; ++i){
+                ppl::vertex<P_TYPE, DIM> _low{low}, _high{high};
+                for(uint32_t j{1}; j < ppl::cubic_points; ++j){
+                    _low = ppl::fuse([](auto l, auto c){ return std::min(l, c); }, _low, _points[i*ppl::cubic+j]);
+                    _high = ppl::fuse([](auto h, auto c){ return std::max(h, c); }, _high, _points[i*ppl::cubic+j]);
+                }
+                if(tile.curves > 0 && _high.dist(_low) > _tile_extent)
+                    break;
+                low = _low;
+                high = _high;
+                ++tile.curves;
+            }
+
+            const ppl::vertex<P_TYPE, DIM> centre{(low + high)/2};
+            P_TYPE radius{0};
+            for(uint64_t j{tile.first*ppl::cubic}; j <= i*ppl::cubic; ++j)
+                radius = std::max(radius, _points[j].sqr_dist(centre));
+            tile.radius = std::sqrt(radius);
+            ppl::for_each_coord<DIM>([&](auto k){ tile.centre[k] = centre.template get<k>(); });
+            _directory.push_back(tile);
+        }
+
+        uint64_t _offset{sizeof(_header) + sizeof(_tile)*_directory.size()};
+        for(_tile& tile : _directory){
+            _offset = (_offset + page - 1)/page*page;
+            tile.offset = _offset;
+            _offset += sizeof(ppl::vertex<P_TYPE, DIM>)*(tile.curves*ppl::cubic + 1);
+        }
+
+        _header h{};
+        memcpy(h.magic, magic, sizeof(magic));
+        h.version = version;
+        h.dim = DIM;
+        h.vertex_bytes = sizeof(ppl::vertex<P_TYPE, DIM>);
+        h.curves = _curves;
+        h.tiles = _directory.size();
+
+        std::ofstream file(_dir, std::ios::binary | std::ios::trunc);
+        if(!file)
+            throw std::runtime_error("could not open file <"+_dir+">\n");
+        file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        file.write(reinterpret_cast<const char*>(_directory.data()), sizeof(_tile)*_directory.size());
+        const std::vector<char> padding(page, 0);
+        for(const _tile& tile : _directory){
+            file.write(padding.data(), tile.offset - file.tellp());
+            file.write(reinterpret_cast<const char*>(_points + tile.first*ppl::cubic), 
+                        sizeof(ppl::vertex<P_TYPE, DIM>)*(tile.curves*ppl::cubic + 1));
+        }
+        if(!file)
+            throw std::runtime_error("could not write file <"+_dir+">\n");
+    }
+
+    static bool is_store(const void* const _data, const std::size_t& _size){
+        return _size >= sizeof(magic) && memcmp(_data, magic, sizeof(magic)) == 0;
+    }
+
+
+    /*
+     * The closest point of the track to 'p'. The index is walked nearer
+     * boxes first, and only the tiles whose sphere is closer than the best
+     * distance found so far are queried.
+     */
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p)
+    {
+        ppl::projection<P_TYPE, DIM> best;
+        P_TYPE min_dist{std::numeric_limits<P_TYPE>::max()};
+        bool _found{0};
+
+        // the first tile reached is always queried, so that 'best' is set whatever 'p' is
+        walk(*p, [&](const P_TYPE& _gap){ return _found && _gap > 0 && _gap*_gap >= min_dist; }, 
+            [&](const uint64_t& t){
+                std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> _path;
+                {
+                    std::lock_guard<std::mutex> lock(_guard);
+                    _path = acquire(t);
+                }
+                const ppl::projection<P_TYPE, DIM> curr{_path->closest_point(p)};
+                if(!_found || curr.dist*curr.dist < min_dist){
+                    best = curr;
+                    best.index += directory[t].first;
+                    min_dist = curr.dist*curr.dist;
+                    _found = 1;
+                }
+            });
+
+        return best;
+    }
+
+    // same as localize(p), and reads ahead the tiles the queries of '_cursor' head to
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p, cursor& _cursor)
+    {
+        const ppl::projection<P_TYPE, DIM> best{localize(p)};
+        if(_cursor.moving){
+            // the ball around the next 'lookahead' steps at the pace of the last one
+            const ppl::vertex<P_TYPE, DIM> ahead{static_cast<P_TYPE>(
+                        lookahead.load(std::memory_order_relaxed))*(*p - _cursor.last)/2};
+            __prefetch(*p + ahead, std::sqrt(ahead.dot(ahead)));
+        }
+        _cursor.last = *p;
+        _cursor.moving = 1;
+        return best;
+    }
+
+    /*
+     * Reads ahead the tiles within 'radius' of 'p' which aren't resident,
+     * without waiting for them. localize() with a cursor does it on its own
+     * for the area the queries head to, 'lookahead' steps of the last move
+     * ahead.
+     */
+    void prefetch(const ppl::vertex<P_TYPE, DIM>& p, const P_TYPE& radius){
+        __prefetch(p, radius);
+    }
+
+    void set_lookahead(const uint32_t& _steps){
+        lookahead.store(_steps, std::memory_order_relaxed);
+    }
+
+    void set_budget(const std::size_t& _budget){
+        std::lock_guard<std::mutex> lock(_guard);
+        budget = _budget;
+        while(_resident_bytes > budget && !lru.empty())
+            evict(lru.back());
+    }
+
+    uint64_t curves(void) const { return header.curves; }
+    uint64_t tiles(void) const { return header.tiles; }
+
+    uint64_t resident_tiles(void) const { 
+        std::lock_guard<std::mutex> lock(_guard);
+        return resident.size(); 
+    }
+
+    std::size_t resident_bytes(void) const { 
+        std::lock_guard<std::mutex> lock(_guard);
+        return _resident_bytes; 
+    }
+
+    // tiles paged in, dropped to stay within the budget, and read ahead so far
+    uint64_t loads(void) const { 
+        std::lock_guard<std::mutex> lock(_guard);
+        return _loads; 
+    }
+
+    uint64_t evictions(void) const { 
+        std::lock_guard<std::mutex> lock(_guard);
+        return _evictions; 
+    }
+
+    uint64_t prefetches(void) const { 
+        std::lock_guard<std::mutex> lock(_guard);
+        return _prefetches; 
+    }
+};
+
+
+} // namespace ppl
+
+
+#endif   //  PPL_EXTERNAL_TRACK_LOADING
+
+#endif   //  PPL_TILE_STORE_HPP
@@ -0,0 +1,273 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+#ifndef PPL_TILED_PATH_HPP
+#define PPL_TILED_PATH_HPP
+
+
+
+#include "ppl_numeric_mth.hpp"
+
+
+namespace ppl
+{
+
+/*
+ * A read-only path that keeps its coefficients in a narrower type 'STORE'
+ * (float by default) to halve the memory and bandwidth of large tracks in
+ * projected coordinates "e.g. UTM", where a double is needed only because of
+ * the magnitude of the coordinates, not their resolution.
+ *
+ * Consecutive curves are grouped in tiles. Every tile keeps its origin "its
+ * first control point" in P_TYPE and the curves of the tile keep their
+ * coefficients relative to that origin in STORE. On a query, the point is
+ * moved to the tile's frame in P_TYPE and the coefficients are promoted to
+ * P_TYPE, so every result is computed and returned in P_TYPE. The only error
+ * is the rounding of the relative geometry, see max_storage_error().
+ */
+template<typename P_TYPE, typename STORE = float, std::size_t DIM = 3>
+class tiled_path : public ppl::curve_solver<P_TYPE, DIM>
+{
+
+    struct _packed_curve{
+        ppl::vertex<STORE, DIM> parametric[ppl::cubic_Coeffs];  // relative to the tile's origin
+        STORE poly[ppl::quintic_Coeffs];
+    };
+
+    std::pmr::vector<ppl::vertex<P_TYPE, DIM>> origins;
+    std::pmr::vector<_packed_curve> packed;
+
+    uint64_t tile_curves;
+    P_TYPE storage_error{0};
+
+    using ppl::curve_solver<P_TYPE, DIM>::extract_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::object_coeffs;
+    using ppl::curve_solver<P_TYPE, DIM>::is_cubic;
+    using ppl::curve_solver<P_TYPE, DIM>::lower_degree;
+    using ppl::curve_solver<P_TYPE, DIM>::call_significant_fig_ascertain;
+    using ppl::curve_solver<P_TYPE, DIM>::project_on_curve;
+    using ppl::curve_solver<P_TYPE, DIM>::poly3d_solve_for;
+    using ppl::curve_solver<P_TYPE, DIM>::deriv3d_solve_for;
+
+
+    template<typename T>
+    static ppl::vertex<P_TYPE, DIM> promote(const ppl::vertex<T, DIM>& v){
+        return ppl::make_vertex<P_TYPE, DIM>([&](auto k){ 
+            return static_cast<P_TYPE>(v.template get<k>()); });
+    }
+
+    template<typename T>
+    static ppl::vertex<STORE, DIM> demote(const ppl::vertex<T, DIM>& v){
+        return ppl::make_vertex<STORE, DIM>([&](auto k){ 
+            return static_cast<STORE>(v.template get<k>()); });
+    }
+
+    PPL_FUNC_DECL void unpack(const uint64_t& i, 
+                ppl::poly3d<P_TYPE, DIM>& _parametric, 
+                ppl::deriv3d<P_TYPE, DIM>& _deriv, 
+                ppl::poly1d<P_TYPE>& _poly) const
+    {
+        uint32_t j{0};
+        for(; j<ppl::cubic_Coeffs; ++j)
+            _parametric.coeffs[j] = promote(packed[i].parametric[j]);
+        for(j=0; j<ppl::cubic; ++j)
+            _deriv.coeffs[j] = (ppl::cubic-j) * _parametric.coeffs[j];
+        for(j=0; j<ppl::quintic_Coeffs; ++j)
+            _poly.coeffs[j] = packed[i].poly[j];
+    }
+
+    // the end point of a curve relative to its tile's origin
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM> end_point(const ppl::poly3d<P_TYPE, DIM>& _parametric) const {
+        return _parametric.coeffs[0] + _parametric.coeffs[1] 
+                + _parametric.coeffs[2] + _parametric.coeffs[3];
+    }
+
+    void pack(const uint64_t& i, const ppl::vertex<P_TYPE, DIM>* const points)
+    {
+        const ppl::vertex<P_TYPE, DIM>& origin = origins[i/tile_curves];
+
+        ppl::vertex<P_TYPE, DIM> rel[ppl::cubic_points];
+        for(uint32_t j{0}; j<ppl::cubic_points; ++j)
+            rel[j] = points[j] - origin;
+
+        ppl::poly3d<P_TYPE, DIM> _parametric;
+        ppl::deriv3d<P_TYPE, DIM> _deriv;
+        ppl::poly1d<P_TYPE> _poly;
+        extract_coeffs(rel, _parametric, _deriv, _poly);
+
+        // the quintic is built from the rounded geometry, so the roots
+        // belong to the curve that is actually stored
+        uint32_t j{0};
+        for(; j<ppl::cubic_Coeffs; ++j){
+            packed[i].parametric[j] = demote(_parametric.coeffs[j]);
+            _parametric.coeffs[j] = promote(packed[i].parametric[j]);
+        }
+
+        const ppl::vertex<P_TYPE, DIM>* const a = _parametric.coeffs;
+        const P_TYPE aa{a[0].dot(a[0])}, bb{a[1].dot(a[1])}, cc{a[2].dot(a[2])};
+        if(is_cubic(aa, bb, cc, a[3].dot(a[3]))){
+            object_coeffs(_parametric, aa, bb, cc, _poly);
+            for(j=0; j<ppl::quintic_Coeffs; ++j)
+                packed[i].poly[j] = static_cast<STORE>(_poly.coeffs[j]);
+        }
+        else{   // rounding noise in the cubic term is dropped with it
+            lower_degree(_parametric, _deriv, _poly);
+            packed[i].parametric[0] = demote(_parametric.coeffs[0]);
+            for(j=0; j<ppl::quintic_Coeffs; ++j)
+                packed[i].poly[j] = 0;
+        }
+
+        // control points reconstructed from what is stored
+        const ppl::vertex<P_TYPE, DIM>* const c = _parametric.coeffs;
+        const ppl::vertex<P_TYPE, DIM> stored[ppl::cubic_points]={ 
+            c[3], c[3] + c[2]/3.0, c[3] + (2.0*c[2] + c[1])/3.0, end_point(_parametric) };
+        for(j=0; j<ppl::cubic_points; ++j)
+            storage_error = std::max(storage_error, stored[j].dist(rel[j]));
+    }
+
+public:
+
+    explicit tiled_path(uint64_t _tile_curves = 256, 
+            std::pmr::memory_resource* __resource = std::pmr::get_default_resource()):
+            origins(__resource), packed(__resource), tile_curves{_tile_curves}
+    {
+        ppl_assert__(std::numeric_limits<P_TYPE>::is_iec559 
+            && std::numeric_limits<STORE>::is_iec559, 
+            "instantiation of ppl::tiled_path can only be with floating-point types!\n");
+        ppl_assert__(tile_curves > 0, "a tile needs at least one curve!");
+    }
+
+    tiled_path(const ppl::vertex<P_TYPE, DIM>* const points, const uint64_t& _size, 
+            uint64_t _tile_curves = 256): tiled_path(_tile_curves) {
+        routing(points, _size);
+    }
+
+
+    void routing(const ppl::vertex<P_TYPE, DIM>* const points, 
+                    const uint64_t& _size)
+    {
+        ppl_assert__( (_size -1)%ppl::cubic == 0 && _size > ppl::cubic, 
+                    "incompatible number of control points!");
+        call_significant_fig_ascertain();
+
+        const uint64_t _curves{(_size-1)/ppl::cubic};
+        storage_error = 0;
+        origins.clear();
+        for(uint64_t i{0}; i<_curves; i+=tile_curves)
+            origins.push_back(points[i*ppl::cubic]);
+
+        packed.resize(_curves);
+        for(uint64_t i{0}; i<_curves; ++i)
+            pack(i, points+i*ppl::cubic);
+    }
+
+
+    PPL_FUNC_DECL ppl::projection<P_TYPE, DIM> 
+    closest_point(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        ppl_assert__(!packed.empty(), 
+            "closest point was called on empty data! did you forget to load your data?\n");
+
+        ppl::projection<P_TYPE, DIM> point_projection;
+        point_projection.index = 0;
+        point_projection.parameter = 0;
+
+        ppl::poly3d<P_TYPE, DIM> _parametric;
+        ppl::deriv3d<P_TYPE, DIM> _deriv;
+        ppl::poly1d<P_TYPE> _poly;
+        ppl::solver_scratch<P_TYPE, ALTERS_PRECISION> scratch;
+
+        // distances are compared in the frame of each tile
+        P_TYPE min_dist{(*p).sqr_dist(origins[0])}, curr_dist;
+
+        for(uint64_t t{0}; t<origins.size(); ++t)
+        {
+            const ppl::vertex<P_TYPE, DIM> rel = *p - origins[t];
+            const uint64_t last = std::min<uint64_t>((t+1)*tile_curves, packed.size());
+
+            for(uint64_t i{t*tile_curves}; i<last; ++i)
+            {
+                unpack(i, _parametric, _deriv, _poly);
+
+                curr_dist = rel.sqr_dist(end_point(_parametric));
+                if (min_dist > curr_dist){
+                    point_projection.index = i;
+                    point_projection.parameter = static_cast<P_TYPE>(1);
+                    min_dist = curr_dist;
+                }
+
+                if(project_on_curve(_parametric, _deriv, _poly, rel, 
+                                min_dist, point_projection.parameter, scratch))
+                    point_projection.index = i;
+            }
+        }
+
+        unpack(point_projection.index, _parametric, _deriv, _poly);
+        point_projection.closest = origins[point_projection.index/tile_curves] 
+                + poly3d_solve_for(_parametric, point_projection.parameter);
+        point_projection.dist = point_projection.closest.dist(*p);
+        point_projection.tan = deriv3d_solve_for(_deriv, point_projection.parameter);
+        return point_projection;
+    }
+
+
+    uint64_t curves(void) const { return packed.size(); }
+
+    uint64_t tiles(void) const { return origins.size(); }
+
+    // bytes per curve against cubic_path<P_TYPE>::bytes_per_curve()
+    static constexpr std::size_t bytes_per_curve(void) {
+        return sizeof(_packed_curve);
+    }
+
+    std::size_t footprint(void) const {
+        return sizeof(_packed_curve)*packed.capacity() 
+            + sizeof(ppl::vertex<P_TYPE, DIM>)*origins.capacity();
+    }
+
+    /*
+     * The largest distance between a control point given to routing() and
+     * the same control point reconstructed from the stored coefficients.
+     */
+    P_TYPE max_storage_error(void) const { return storage_error; }
+
+};
+
+} // namespace ppl
+
+#endif //  PPL_TILED_PATH_HPP
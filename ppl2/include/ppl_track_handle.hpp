@@ -0,0 +1,173 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+#ifndef PPL_TRACK_HANDLE_HPP
+#define PPL_TRACK_HANDLE_HPP
+
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <vector>
+
+
+namespace ppl
+{
+
+/*
+ * A read-copy-update handle over a precomputed track. Readers take a
+ * snapshot (a reference counted pointer to an immutable cubic_path) and
+ * query it without taking the mutex of the writers, while a writer builds
+ * the replacement aside and publishes it atomically. The replaced track is
+ * reclaimed as soon as the last reader holding a snapshot of it drops
+ * that snapshot.
+ *
+ * Taking and publishing a snapshot are the atomic shared_ptr functions,
+ * which libstdc++ implements with a small pool of internal locks held for
+ * the copy of the pointer only: a reader may briefly spin on the store of
+ * a writer, but never waits for a track to be built. They are not
+ * lock-free.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class track_handle
+{
+	static_assert(std::numeric_limits<P_TYPE>::is_iec559,
+		"instantiation of ppl::track_handle can only be with floating-point types!\n");
+
+public:
+    typedef std::shared_ptr<const ppl::cubic_path<P_TYPE, DIM>> snapshot;
+
+private:
+    snapshot _track;
+    std::atomic<uint64_t> _epoch{0};
+    std::mutex _publishing;
+
+    // tracks are ordered by when they were asked for, not by when their build ends
+    std::atomic<uint64_t> _requested{0};
+    uint64_t _live{0};   // the request of the published track, under '_publishing'
+
+    uint64_t __publish(snapshot __track, const uint64_t& _request){
+        ppl_assert__(__track != nullptr, "publishing an empty track!");
+
+        std::lock_guard<std::mutex> lock(_publishing);
+        if(_request < _live)
+            return _epoch.load(std::memory_order_acquire);
+        _live = _request;
+        std::atomic_store(&_track, std::move(__track));
+        return _epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    uint64_t __routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size, const uint64_t& _request){
+
+        return __publish(std::make_shared<const ppl::cubic_path<P_TYPE, DIM>>(_points, __size), _request);
+    }
+
+public:
+    track_handle() = default;
+    track_handle(const track_handle&) = delete;
+    track_handle& operator=(const track_handle&) = delete;
+
+    track_handle(ppl::vertex<P_TYPE, DIM> const * const _points,
+        const uint64_t& __size) {
+
+        routing(_points, __size);
+    }
+
+    // current version of the track, valid for as long as the caller holds it
+    snapshot acquire(void) const {
+        return std::atomic_load(&_track);
+    }
+
+    /*
+     * Number of tracks published so far. It is bumped once the track is
+     * published, so it may lag a snapshot taken meanwhile, but never leads:
+     * once it reads N, acquire() returns the N-th track or a newer one.
+     */
+    uint64_t epoch(void) const {
+        return _epoch.load(std::memory_order_acquire);
+    }
+
+    /*
+     * Swaps '__track' in and returns the epoch it's published at. Tracks
+     * asked for concurrently are published in the order they were asked
+     * for: a track older than the one already published is dropped, and
+     * the current epoch is returned instead.
+     */
+    uint64_t publish(snapshot __track){
+
+        return __publish(std::move(__track), ++_requested);
+    }
+
+    /*
+     * Builds the new track on the calling thread and swaps it in.
+     * Queries running in the meantime keep working on the old track.
+     */
+    uint64_t routing(ppl::vertex<P_TYPE, DIM> const * const _points, 
+                const uint64_t& __size){
+
+        return __routing(_points, __size, ++_requested);
+    }
+
+    /*
+     * Same as routing(), but the track is built on a background thread.
+     * The returned future holds the epoch of the published track, or the
+     * exception thrown while building it. Dropping the future waits for
+     * the build, hence [[nodiscard]].
+     */
+    [[nodiscard]] std::future<uint64_t> routing_async(std::vector<ppl::vertex<P_TYPE, DIM>> _points){
+
+        return std::async(std::launch::async, 
+            [this](std::vector<ppl::vertex<P_TYPE, DIM>> __points, const uint64_t _request) -> uint64_t {
+                return __routing(__points.data(), __points.size(), _request);
+            }, std::move(_points), ++_requested);
+    }
+
+    ppl::projection<P_TYPE, DIM> localize(ppl::vertex<P_TYPE, DIM> const * const p) const
+    {
+        snapshot __track{acquire()};
+        ppl_assert__(__track != nullptr, 
+            "closest point was called on empty data! did you forget to load your data?\n");
+
+        return __track->closest_point(p);
+    }
+};
+
+
+} // namespace ppl
+
+
+#endif   //  PPL_TRACK_HANDLE_HPP
@@ -0,0 +1,222 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+#ifndef PPL_TRACK_WATCHER_HPP
+#define PPL_TRACK_WATCHER_HPP
+
+
+#ifdef PPL_EXTERNAL_TRACK_LOADING
+
+#if !defined(__linux__) || !__has_include(<sys/inotify.h>)
+#error "watching external tracks is only supported on Linux!"
+#endif
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+
+
+namespace ppl
+{
+
+/*
+ * Watches the file of an external track and reloads it whenever it changes.
+ * The file is parsed and the new path is precomputed on the watcher's own
+ * thread, then published through a ppl::track_handle, so that queries going
+ * through the handle never wait for a reload. A file that fails to load
+ * leaves the current path in place.
+ *
+ * The directory containing the file is watched rather than the file itself,
+ * so that files replaced by renaming (as most editors and deploy tools do)
+ * are picked up too. A reload starts once the file is closed after writing,
+ * or renamed into place. Writers should write a temporary file and rename
+ * it, a file rewritten in place may be read while half written.
+ */
+template<typename P_TYPE, std::size_t DIM = 3> class track_watcher
+{
+    ppl::track_handle<P_TYPE, DIM>& _handle;
+    std::string _dir, _name;
+
+    signed i_descriptor{-1};
+    signed stop_pipe[2]{-1, -1};
+    std::thread watcher;
+
+    std::atomic<uint64_t> _reloads{0}, _failures{0};
+    std::atomic<int64_t> _last_latency{0}, _max_latency{0};
+
+    mutable std::mutex _err_guard;
+    std::string _last_error;
+
+
+    void reload(void){
+        auto start = std::chrono::steady_clock::now();
+
+        try{
+            std::vector<ppl::vertex<P_TYPE, DIM>> __points;
+            ppl::load_control_points(_dir + _name, __points);
+            _handle.routing(__points.data(), __points.size());
+        }
+        catch(const std::exception& e){
+            std::lock_guard<std::mutex> lock(_err_guard);
+            _last_error = e.what();
+            _failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+        _last_latency.store(latency, std::memory_order_relaxed);
+        if(latency > _max_latency.load(std::memory_order_relaxed))
+            _max_latency.store(latency, std::memory_order_relaxed);
+        _reloads.fetch_add(1, std::memory_order_release);
+    }
+
+    void watch(void){
+        alignas(struct inotify_event) char events[0x1000];
+        pollfd fds[2]{ {i_descriptor, POLLIN, 0}, {stop_pipe[0], POLLIN, 0} };
+
+        for(;;){
+            if(poll(fds, 2, -1) < 0){
+                if(errno == EINTR) continue;
+                return;
+            }
+            if(fds[1].revents) 
+                return;
+
+            bool touched{0};
+            ssize_t len;
+            while((len = read(i_descriptor, events, sizeof(events))) > 0){
+                for(char* ptr = events; ptr < events + len; ){
+                    const struct inotify_event* event = 
+                            reinterpret_cast<const struct inotify_event*>(ptr);
+                    if(event->len && _name == event->name)
+                        touched = 1;
+                    ptr += sizeof(struct inotify_event) + event->len;
+                }
+            }
+
+            if(touched)
+                reload();
+        }
+    }
+
+    void cleanUp(void){
+        if(watcher.joinable()){
+            char stop{0};
+            if(write(stop_pipe[1], &stop, 1) < 0){} 
+            watcher.join();
+        }
+        auto __close = [](signed& fd){
+            if(fd >= 0){
+                close(fd);
+                fd = -1;
+            }
+        };
+        __close(i_descriptor);
+        __close(stop_pipe[0]);
+        __close(stop_pipe[1]);
+    }
+
+public:
+    track_watcher(const track_watcher&) = delete;
+    track_watcher& operator=(const track_watcher&) = delete;
+
+    /*
+     * Loads the file into '__handle' once on the calling thread, exactly as
+     * point_projection::routing(fileName) does, then starts watching it.
+     */
+    track_watcher(ppl::track_handle<P_TYPE, DIM>& __handle, const std::string& _file)
+        : _handle{__handle}
+    {
+        fs::path __path{fs::absolute(_file)};
+        _dir = __path.parent_path().string() + "/";
+        _name = __path.filename().string();
+
+        std::vector<ppl::vertex<P_TYPE, DIM>> __points;
+        ppl::load_control_points(_file, __points);
+        _handle.routing(__points.data(), __points.size());
+
+        i_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(i_descriptor < 0)
+            throw std::runtime_error("could not initialize inotify for <"+_file+">\n");
+
+        if(inotify_add_watch(i_descriptor, _dir.c_str(), 
+                IN_CLOSE_WRITE | IN_MOVED_TO) < 0){
+            cleanUp();
+            throw std::runtime_error("could not watch the directory of <"+_file+">\n");
+        }
+
+        if(pipe(stop_pipe) < 0){
+            cleanUp();
+            throw std::runtime_error("could not create the stop channel of the watcher\n");
+        }
+
+        watcher = std::thread(&track_watcher::watch, this);
+    }
+
+    virtual ~track_watcher(){ cleanUp(); }
+
+    // number of successful reloads since the watcher was started
+    uint64_t reloads(void) const { return _reloads.load(std::memory_order_acquire); }
+
+    // number of changes to the file that could not be loaded
+    uint64_t failures(void) const { return _failures.load(std::memory_order_relaxed); }
+
+    // time from noticing a change until the new path was published
+    std::chrono::nanoseconds last_reload_latency(void) const { 
+        return std::chrono::nanoseconds{_last_latency.load(std::memory_order_relaxed)}; 
+    }
+
+    std::chrono::nanoseconds max_reload_latency(void) const { 
+        return std::chrono::nanoseconds{_max_latency.load(std::memory_order_relaxed)}; 
+    }
+
+    std::string last_error(void) const {
+        std::lock_guard<std::mutex> lock(_err_guard);
+        return _last_error;
+    }
+};
+
+
+} // namespace ppl
+
+
+#endif   //  PPL_EXTERNAL_TRACK_LOADING
+
+#endif   //  PPL_TRACK_WATCHER_HPP
@@ -48,27 +48,162 @@
 #include <initializer_list>
 
 
+#if defined(PPL_PADDED_VERTEX) && !(defined(__GNUC__) || defined(__clang__))
+#error "padded vertices need the vector extensions of gcc or clang!"
+#endif
+
+
 
 
 namespace ppl
 {
 
+// with PPL_PADDED_VERTEX a 3D vertex of float or double is padded to four lanes
+template<typename P_TYPE, std::size_t DIM>
+constexpr bool padded_vertex{
+#ifdef PPL_PADDED_VERTEX
+    DIM == 3 && (std::is_same<P_TYPE, float>::value || std::is_same<P_TYPE, double>::value)
+#else
+    false
+#endif
+};
+
+
+/*
+ * The coordinates of a vertex. 2D and 3D vertices keep named coordinates,
+ * any other dimension keeps an array. Either way a coordinate is reached at
+ * compile time by get<I>(), so the operations of ppl::vertex unroll into
+ * exactly DIM scalar operations.
+ */
+template<typename P_TYPE, std::size_t DIM, bool PADDED = ppl::padded_vertex<P_TYPE, DIM>>
+struct vertex_coords{
+
+    template<std::size_t I>
+    PPL_FUNC_DECL P_TYPE& get(void) { return c[I]; }
+
+    template<std::size_t I>
+    PPL_FUNC_DECL const P_TYPE& get(void) const { return c[I]; }
+
+    P_TYPE c[DIM];
+};
+
 template<typename P_TYPE>
-struct vertex{
+struct vertex_coords<P_TYPE, 2, false>{
+
+    template<std::size_t I>
+    PPL_FUNC_DECL P_TYPE& get(void) { 
+        if constexpr(I == 0) return x; else return y; 
+    }
+
+    template<std::size_t I>
+    PPL_FUNC_DECL const P_TYPE& get(void) const { 
+        if constexpr(I == 0) return x; else return y; 
+    }
+
+	union { P_TYPE x, r, s; };
+	union { P_TYPE y, g, t; };
+};
+
+template<typename P_TYPE>
+struct vertex_coords<P_TYPE, 3, false>{
+
+    template<std::size_t I>
+    PPL_FUNC_DECL P_TYPE& get(void) { 
+        if constexpr(I == 0) return x; else if constexpr(I == 1) return y; else return z; 
+    }
+
+    template<std::size_t I>
+    PPL_FUNC_DECL const P_TYPE& get(void) const { 
+        if constexpr(I == 0) return x; else if constexpr(I == 1) return y; else return z; 
+    }
+
+	union { P_TYPE x, r, s; };
+	union { P_TYPE y, g, t; };
+	union { P_TYPE z, b, p; };
+};
+
+#ifdef PPL_PADDED_VERTEX
+/*
+ * A padded 3D vertex, xyz and a fourth lane 'w' aligned to the size of all
+ * four, so it is loaded and stored as one vector register "one ymm of AVX
+ * for double, two xmm of SSE2". The arithmetic of ppl::vertex runs on all
+ * the lanes at once, dot and sqr_dist add up xyz only. 'w' takes part in no
+ * result and is kept at zero, so the padding never raises floating-point
+ * exceptions nor hits denormals, and is stored as zero. A vertex<double>
+ * takes 32 bytes instead of 24.
+ */
+template<typename P_TYPE>
+struct alignas(4*sizeof(P_TYPE)) vertex_coords<P_TYPE, 3, true>{
+
+    typedef P_TYPE simd_t __attribute__((vector_size(4*sizeof(P_TYPE))));
+
+    template<std::size_t I>
+    PPL_FUNC_DECL P_TYPE& get(void) { 
+        if constexpr(I == 0) return x; else if constexpr(I == 1) return y; else return z; 
+    }
+
+    template<std::size_t I>
+    PPL_FUNC_DECL const P_TYPE& get(void) const { 
+        if constexpr(I == 0) return x; else if constexpr(I == 1) return y; else return z; 
+    }
+
+    vertex_coords(): v{} {}
+
+    PPL_FORCEINLINE const simd_t& lanes(void) const { return v; }
+
+    // 'w' is set back to zero, whatever the arithmetic left in it
+    PPL_FORCEINLINE void lanes(const simd_t& _v) { v = simd_t{_v[0], _v[1], _v[2], 0}; }
+
+    // 'v' holds the four lanes
+    union {
+        simd_t v;
+        struct {
+            union { P_TYPE x, r, s; };
+            union { P_TYPE y, g, t; };
+            union { P_TYPE z, b, p; };
+            P_TYPE w;
+        };
+    };
+};
+#endif
+
 
+// calls 'f' with std::integral_constant<std::size_t, I> for I in [0, DIM)
+template<std::size_t DIM, typename F>
+PPL_FUNC_DECL void for_each_coord(F&& f);
+
+// the sum of 'f(I)' for I in [0, DIM)
+template<std::size_t DIM, typename F>
+PPL_FUNC_DECL auto sum_coords(F&& f);
+
+// the vertex made of 'f(I)' for I in [0, DIM)
+template<typename P_TYPE, std::size_t DIM, typename F>
+PPL_FUNC_DECL auto make_vertex(F&& f);
+
+
+
+template<typename P_TYPE, std::size_t DIM = 3>
+struct vertex : public ppl::vertex_coords<P_TYPE, DIM>{
+
+    static_assert(DIM > 0, "a vertex needs at least one coordinate!");
+
+    static constexpr std::size_t dim{DIM};
+    static constexpr bool padded{ppl::padded_vertex<P_TYPE, DIM>};
+
+    using ppl::vertex_coords<P_TYPE, DIM>::get;
 
 
     template<typename T>
-    PPL_FUNC_DECL auto dot(const ppl::vertex<T>&) const 
+    PPL_FUNC_DECL auto dot(const ppl::vertex<T, DIM>&) const 
         -> decltype(std::declval<P_TYPE>() * std::declval<T>());
 
     template<typename T>
-    PPL_FUNC_DECL auto sqr_dist(const ppl::vertex<T>&) const 
+    PPL_FUNC_DECL auto sqr_dist(const ppl::vertex<T, DIM>&) const 
         -> decltype(std::declval<P_TYPE>() + std::declval<T>());
 
 
     template<typename T>
-    PPL_FUNC_DECL auto dist(const ppl::vertex<T>&) const 
+    PPL_FUNC_DECL auto dist(const ppl::vertex<T, DIM>&) const 
         -> decltype(std::declval<P_TYPE>() + std::declval<T>());
 
 
@@ -86,150 +221,159 @@ struct vertex{
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator=(const T&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator=(const T&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator+=(const ppl::vertex<T>&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator+=(const ppl::vertex<T, DIM>&);
 
         
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator-=(const ppl::vertex<T>&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator-=(const ppl::vertex<T, DIM>&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator*=(const ppl::vertex<T>&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator*=(const ppl::vertex<T, DIM>&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator/=(const ppl::vertex<T>&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator/=(const ppl::vertex<T, DIM>&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator+=(const T&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator+=(const T&);
 
         
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator-=(const T&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator-=(const T&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator*=(const T&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator*=(const T&);
 
 
     template<typename T>
-    PPL_FUNC_DECL ppl::vertex<P_TYPE>& operator/=(const T&);
+    PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& operator/=(const T&);
 
 
+    // one value per coordinate, vertex<double>(x, y, z) or vertex<double, 2>(x, y)
+    template<typename... T, typename = std::enable_if_t<
+            sizeof...(T) == DIM && (DIM > 1) && (std::is_arithmetic<T>::value && ...)>>
+    vertex(const T&...);
 
-    vertex(const P_TYPE&, const P_TYPE&, const P_TYPE&);
-    vertex(const ppl::vertex<P_TYPE>&)= default;
+    vertex(const ppl::vertex<P_TYPE, DIM>&)= default;
     vertex(const P_TYPE&);
     vertex() = default;
 
-    vertex(ppl::vertex<P_TYPE>&&)= default;
-    vertex<P_TYPE>& operator=(const vertex<P_TYPE>&) = default;
-    vertex<P_TYPE>& operator=(vertex<P_TYPE>&&) = default;
-
-
-	union { P_TYPE x, r, s; };
-	union { P_TYPE y, g, t; };
-	union { P_TYPE z, b, p; };
+    vertex(ppl::vertex<P_TYPE, DIM>&&)= default;
+    vertex<P_TYPE, DIM>& operator=(const vertex<P_TYPE, DIM>&) = default;
+    vertex<P_TYPE, DIM>& operator=(vertex<P_TYPE, DIM>&&) = default;
 
 }; // ppl::vertex
 
 
 
-template<typename P_TYPE>
-std::ostream& operator<<(std::ostream&, const ppl::vertex<P_TYPE>&);
+template<typename P_TYPE, std::size_t DIM>
+std::ostream& operator<<(std::ostream&, const ppl::vertex<P_TYPE, DIM>&);
 
-template<typename P_TYPE>
-PPL_FUNC_DECL std::string operator+(const std::string&, const ppl::vertex<P_TYPE>&);
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL std::string operator+(const std::string&, const ppl::vertex<P_TYPE, DIM>&);
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
 PPL_FUNC_DECL std::string& operator+=
         (std::string& _str, 
-        const ppl::vertex<P_TYPE>& vec);
+        const ppl::vertex<P_TYPE, DIM>& vec);
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL bool operator==(const ppl::vertex<T1>&, const ppl::vertex<T2>&);
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL bool operator==(const ppl::vertex<T1, DIM>&, const ppl::vertex<T2, DIM>&);
 
-template<typename T1, typename T2> 
-PPL_FUNC_DECL bool operator==(const ppl::vertex<T1>&, const T2&);
+template<typename T1, typename T2, std::size_t DIM> 
+PPL_FUNC_DECL bool operator==(const ppl::vertex<T1, DIM>&, const T2&);
 
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> operator^(ppl::vertex<T>, std::size_t);
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> operator^(ppl::vertex<T, DIM>, std::size_t);
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> operator-(const ppl::vertex<T>&);
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> operator-(const ppl::vertex<T, DIM>&);
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const ppl::vertex<T1>&, const ppl::vertex<T2>&) 
-    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const ppl::vertex<T1, DIM>&, const ppl::vertex<T2, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>;
 
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const ppl::vertex<T1>&, const T2&) 
-    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const ppl::vertex<T1, DIM>&, const T2&) 
+    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const T2&, const ppl::vertex<T1>&);
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const T2&, const ppl::vertex<T1, DIM>&);
 
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const ppl::vertex<T1>&, const ppl::vertex<T2>&) 
-    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const ppl::vertex<T1, DIM>&, const ppl::vertex<T2, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const ppl::vertex<T1>&, const T2&) 
-    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const ppl::vertex<T1, DIM>&, const T2&) 
+    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>;
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const T2&, const ppl::vertex<T1>&);
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const T2&, const ppl::vertex<T1, DIM>&)
+    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>;
 
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const ppl::vertex<T1>&, const ppl::vertex<T2>&) 
-    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const ppl::vertex<T1, DIM>&, const ppl::vertex<T2, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const ppl::vertex<T1>&, const T2&) 
-    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const ppl::vertex<T1, DIM>&, const T2&) 
+    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const T2&, const ppl::vertex<T1>&) 
-    -> ppl::vertex<decltype(std::declval<T2>() - std::declval<T1>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const T2&, const ppl::vertex<T1, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T2>() - std::declval<T1>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const ppl::vertex<T1>&, const ppl::vertex<T2>&) 
-    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const ppl::vertex<T1, DIM>&, const ppl::vertex<T2, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const ppl::vertex<T1>&, const T2&) 
-    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const ppl::vertex<T1, DIM>&, const T2&) 
+    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>;
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const T2&, const ppl::vertex<T1>&) 
-    -> ppl::vertex<decltype(std::declval<T2>() / std::declval<T1>())>;
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const T2&, const ppl::vertex<T1, DIM>&) 
+    -> ppl::vertex<decltype(std::declval<T2>() / std::declval<T1>()), DIM>;
+
 
+/*
+ * The vertex made of 'f(vec.get<I>(), vecs.get<I>()...)' for I in [0, DIM),
+ * so a compound expression such as 
+ *     fuse([](auto p0, auto p1){ return 3*(p1 - p0) + p0; }, v0, v1)
+ * takes a single pass over the coordinates and no vertex temporaries.
+ */
+template<typename F, typename P_TYPE, std::size_t DIM, typename... T>
+PPL_FUNC_DECL auto fuse(F&& f, const ppl::vertex<P_TYPE, DIM>& vec, 
+            const ppl::vertex<T, DIM>&... vecs);
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> sqrt(const ppl::vertex<T>&);
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> sqrt(const ppl::vertex<T, DIM>&);
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> normalize(const ppl::vertex<T>);
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> normalize(const ppl::vertex<T, DIM>);
 
 template<typename T1, typename T2>
 PPL_FUNC_DECL auto cross(const ppl::vertex<T1>&, const ppl::vertex<T2>&) 
@@ -36,264 +36,340 @@
  */
     
     
-template<typename P_TYPE>
+    
+template<typename F, std::size_t... I>
+PPL_FUNC_DECL void __for_each_coord(F& f, std::index_sequence<I...>)
+{
+    (f(std::integral_constant<std::size_t, I>{}), ...);
+}
+
+template<std::size_t DIM, typename F>
+PPL_FUNC_DECL void for_each_coord(F&& f)
+{
+    __for_each_coord(f, std::make_index_sequence<DIM>{});
+}
+
+template<typename F, std::size_t... I>
+PPL_FUNC_DECL auto __sum_coords(F& f, std::index_sequence<I...>)
+{
+    return (f(std::integral_constant<std::size_t, I>{}) + ...);
+}
+
+template<std::size_t DIM, typename F>
+PPL_FUNC_DECL auto sum_coords(F&& f)
+{
+    return __sum_coords(f, std::make_index_sequence<DIM>{});
+}
+
+template<typename P_TYPE, std::size_t DIM, typename F, std::size_t... I>
+PPL_FUNC_DECL auto __make_vertex(F& f, std::index_sequence<I...>)
+{
+    if constexpr(DIM == 1)
+        return ppl::vertex<P_TYPE, DIM>(static_cast<P_TYPE>(f(std::integral_constant<std::size_t, 0>{})));
+    else
+        return ppl::vertex<P_TYPE, DIM>(f(std::integral_constant<std::size_t, I>{})...);
+}
+
+template<typename P_TYPE, std::size_t DIM, typename F>
+PPL_FUNC_DECL auto make_vertex(F&& f)
+{
+    return __make_vertex<P_TYPE, DIM>(f, std::make_index_sequence<DIM>{});
+}
+
+// a vertex<T1> and a vertex or a value of T2 are worked out on all lanes at once
+template<typename T1, typename T2, std::size_t DIM>
+constexpr bool __on_lanes{ppl::padded_vertex<T1, DIM> && std::is_same<T1, T2>::value};
+
+template<typename T, std::size_t DIM, typename simd_t>
+PPL_FORCEINLINE ppl::vertex<T, DIM> __from_lanes(const simd_t& v)
+{
+    ppl::vertex<T, DIM> vec;
+    vec.lanes(v);
+    return vec;
+}
+
+// the lanes of a divisor, 'w' set to one so that the padding isn't divided by zero
+template<typename simd_t>
+PPL_FORCEINLINE simd_t __divisor_lanes(const simd_t& v)
+{
+    return simd_t{v[0], v[1], v[2], 1};
+}
+
+
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL auto ppl::vertex<P_TYPE>::dot(const ppl::vertex<T>& vec) const
+PPL_FUNC_DECL auto ppl::vertex<P_TYPE, DIM>::dot(const ppl::vertex<T, DIM>& vec) const
      -> decltype(std::declval<P_TYPE>() * std::declval<T>())
 {
-    return this->x*vec.x+this->y*vec.y+this->z*vec.z;
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>){
+        const auto prod = this->lanes() * vec.lanes();
+        return prod[0] + prod[1] + prod[2];
+    }
+    else return ppl::sum_coords<DIM>([&](auto i){ 
+        return this->template get<i>() * vec.template get<i>(); });
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL auto ppl::vertex<P_TYPE>::sqr_dist(const ppl::vertex<T>& vec) const 
+PPL_FUNC_DECL auto ppl::vertex<P_TYPE, DIM>::sqr_dist(const ppl::vertex<T, DIM>& vec) const 
     -> decltype(std::declval<P_TYPE>() + std::declval<T>())
 {
-    return (this->x-vec.x) * (this->x-vec.x)+ 
-            (this->y-vec.y) * (this->y-vec.y)+
-            (this->z-vec.z) * (this->z-vec.z);
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>){
+        const auto diff = this->lanes() - vec.lanes(), sqr = diff * diff;
+        return sqr[0] + sqr[1] + sqr[2];
+    }
+    else return ppl::sum_coords<DIM>([&](auto i){ 
+        return (this->template get<i>() - vec.template get<i>()) 
+                * (this->template get<i>() - vec.template get<i>()); });
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL auto ppl::vertex<P_TYPE>::dist(const ppl::vertex<T>& vec) const 
+PPL_FUNC_DECL auto ppl::vertex<P_TYPE, DIM>::dist(const ppl::vertex<T, DIM>& vec) const 
     -> decltype(std::declval<P_TYPE>() + std::declval<T>()) 
 {
             
-    return std::sqrt(std::pow(std::abs(this->x-vec.x),2)
-            +std::pow(std::abs(this->y-vec.y),2)
-            +std::pow(std::abs(this->z-vec.z),2));
+    return std::sqrt(this->sqr_dist(vec));
 
 }
 
-template<typename P_TYPE>
-PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE>::length(void) const { 
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE, DIM>::length(void) const { 
 
-    return std::sqrt(this->x*this->x + this->y*this->y + this->z*this->z);  
+    return std::sqrt(this->dot(*this));  
 }
     
-template<typename P_TYPE>
-PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE>::l1norm(void) const { 
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE, DIM>::l1norm(void) const { 
 
-    return std::abs(this->x) + std::abs(this->y) + std::abs(this->z);
+    return ppl::sum_coords<DIM>([&](auto i){ return std::abs(this->template get<i>()); });
 }
 
-template<typename P_TYPE>
-PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE>::l2norm(void) const {
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE, DIM>::l2norm(void) const {
 
     return this->length();
 }
 
 
-template<typename P_TYPE>
-PPL_FUNC_DECL std::string ppl::vertex<P_TYPE>::str(void) const { 
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL std::string ppl::vertex<P_TYPE, DIM>::str(void) const { 
     std::string str;
     return str+=*this;
 }
 
-template<typename P_TYPE>
-PPL_FUNC_DECL P_TYPE& ppl::vertex<P_TYPE>::operator[](const std::size_t inx)
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL P_TYPE& ppl::vertex<P_TYPE, DIM>::operator[](const std::size_t inx)
 {
-    if(inx == 0)
-        return this->x;
-    else if(inx==1)
-        return this->y;
-    else if(inx==2)
-        return this->z;
-    else
+    if(inx >= DIM)
         ppl_out_of_range("subscript out of range!");
+
+    P_TYPE* coord{nullptr};
+    ppl::for_each_coord<DIM>([&](auto i){ 
+        if(i == inx) coord = &this->template get<i>(); });
+    return *coord;
 }
 
-template<typename P_TYPE>
-PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE>::operator[](const std::size_t inx) const
+template<typename P_TYPE, std::size_t DIM>
+PPL_FUNC_DECL P_TYPE ppl::vertex<P_TYPE, DIM>::operator[](const std::size_t inx) const
 {
-    if(inx == 0)
-        return *this->x;
-    else if(inx==1)
-        return *this->y;
-    else if(inx==2)
-        return *this->z;
-    else 
-        ppl_out_of_range("subscript out of range!");
+    return const_cast<ppl::vertex<P_TYPE, DIM>&>(*this)[inx];
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& ppl::vertex<P_TYPE>::operator=(const T& val) 
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& ppl::vertex<P_TYPE, DIM>::operator=(const T& val) 
 {
-    this->x = this->y = this->z = val;
+    ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() = val; });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator+=(const ppl::vertex<T>& vec)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator+=(const ppl::vertex<T, DIM>& vec)
 {
-    this->x+=vec.x;
-    this->y+=vec.y;
-    this->z+=vec.z;
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>)
+        this->lanes(this->lanes() + vec.lanes());
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() += vec.template get<i>(); });
     return *this;
 }
         
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator-=(const ppl::vertex<T>& vec)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator-=(const ppl::vertex<T, DIM>& vec)
 {
-    this->x-=vec.x;
-    this->y-=vec.y;
-    this->z-=vec.z;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>)
+        this->lanes(this->lanes() - vec.lanes());
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() -= vec.template get<i>(); });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator*=(const ppl::vertex<T>& vec)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator*=(const ppl::vertex<T, DIM>& vec)
 {
-    this->x*=vec.x;
-    this->y*=vec.y;
-    this->z*=vec.z;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>)
+        this->lanes(this->lanes() * vec.lanes());
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() *= vec.template get<i>(); });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator/=(const ppl::vertex<T>& vec)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator/=(const ppl::vertex<T, DIM>& vec)
 {
-    this->x/=vec.x;
-    this->y/=vec.y;
-    this->z/=vec.z;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, T, DIM>)
+        this->lanes(this->lanes() / ppl::__divisor_lanes(vec.lanes()));
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() /= vec.template get<i>(); });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator+=(const T& val)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator+=(const T& val)
 {
-    this->x+=val;
-    this->y+=val;
-    this->z+=val;
+    if constexpr(ppl::__on_lanes<P_TYPE, decltype(std::declval<P_TYPE>() + std::declval<T>()), DIM>)
+        this->lanes(this->lanes() + static_cast<P_TYPE>(val));
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() += val; });
     return *this;
 }
         
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator-=(const T& val)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator-=(const T& val)
 {
-    this->x-=val;
-    this->y-=val;
-    this->z-=val;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, decltype(std::declval<P_TYPE>() - std::declval<T>()), DIM>)
+        this->lanes(this->lanes() - static_cast<P_TYPE>(val));
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() -= val; });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator*=(const T& val)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator*=(const T& val)
 {
-    this->x*=val;
-    this->y*=val;
-    this->z*=val;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, decltype(std::declval<P_TYPE>() * std::declval<T>()), DIM>)
+        this->lanes(this->lanes() * static_cast<P_TYPE>(val));
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() *= val; });
     return *this;
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
     template<typename T>
-PPL_FUNC_DECL ppl::vertex<P_TYPE>& 
-    ppl::vertex<P_TYPE>::operator/=(const T& val)
+PPL_FUNC_DECL ppl::vertex<P_TYPE, DIM>& 
+    ppl::vertex<P_TYPE, DIM>::operator/=(const T& val)
 {
-    this->x/=val;
-    this->y/=val;
-    this->z/=val;
-
+    if constexpr(ppl::__on_lanes<P_TYPE, decltype(std::declval<P_TYPE>() / std::declval<T>()), DIM>)
+        this->lanes(this->lanes() / static_cast<P_TYPE>(val));
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() /= val; });
     return *this;
 }
 
-template<typename P_TYPE>
-ppl::vertex<P_TYPE>::vertex(const P_TYPE& X, const P_TYPE& Y, const P_TYPE& Z)
-    : x{X}, y{Y}, z{Z} {}
+template<typename P_TYPE, std::size_t DIM>
+    template<typename... T, typename>
+ppl::vertex<P_TYPE, DIM>::vertex(const T&... vals)
+{
+    const P_TYPE coords[DIM]{static_cast<P_TYPE>(vals)...};
+    if constexpr(padded)
+        this->lanes(typename vertex::simd_t{coords[0], coords[1], coords[2], 0});
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() = coords[i]; });
+}
 
 // template<typename P_TYPE>  /***** defaulted *****/
 // ppl::vertex<P_TYPE>::vertex(const ppl::vertex<P_TYPE>& vec)
 //     : x{vec.x}, y{vec.y},z{vec.z}{} 
 
-template<typename P_TYPE>
-ppl::vertex<P_TYPE>::vertex(const P_TYPE& val)
-    : x{val}, y{val}, z{val} {} 
+template<typename P_TYPE, std::size_t DIM>
+ppl::vertex<P_TYPE, DIM>::vertex(const P_TYPE& val)
+{
+    if constexpr(padded)
+        this->lanes(typename vertex::simd_t{val, val, val, 0});
+    else
+        ppl::for_each_coord<DIM>([&](auto i){ this->template get<i>() = val; });
+} 
 
 
-template<typename P_TYPE>
-std::ostream& operator<<(std::ostream& out_s, const ppl::vertex<P_TYPE>& vec) 
+template<typename P_TYPE, std::size_t DIM>
+std::ostream& operator<<(std::ostream& out_s, const ppl::vertex<P_TYPE, DIM>& vec) 
 {
     auto c_prec = out_s.precision();
     out_s.precision(std::numeric_limits<P_TYPE>::digits10);
-    out_s << std::fixed 
-        << vec.x << " "
-        << vec.y << " "
-        << vec.z;
+    out_s << std::fixed << vec.template get<0>();
+    ppl::for_each_coord<DIM>([&](auto i){ 
+        if constexpr(i > 0) out_s << " " << vec.template get<i>(); });
 	out_s.precision(c_prec);
     return out_s;
     
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
 PPL_FUNC_DECL std::string operator+
-    (const std::string& _str, const ppl::vertex<P_TYPE>& vec)
+    (const std::string& _str, const ppl::vertex<P_TYPE, DIM>& vec)
 {
     std::stringstream str_stream;
     str_stream.precision(std::numeric_limits<P_TYPE>::digits10);
-    str_stream << std::fixed <<
-         " " << vec.x <<
-         " " << vec.y << 
-         " " << vec.z;
+    str_stream << std::fixed;
+    ppl::for_each_coord<DIM>([&](auto i){ str_stream << " " << vec.template get<i>(); });
 
     return _str+str_stream.str();
     
 }
 
-template<typename P_TYPE>
+template<typename P_TYPE, std::size_t DIM>
 PPL_FUNC_DECL std::string& operator+=
         (std::string& _str, 
-        const ppl::vertex<P_TYPE>& vec){
+        const ppl::vertex<P_TYPE, DIM>& vec){
     _str = _str+vec;
     return _str;
 }
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL bool operator==(const ppl::vertex<T1>& vec1, 
-            const ppl::vertex<T2>& vec2)
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL bool operator==(const ppl::vertex<T1, DIM>& vec1, 
+            const ppl::vertex<T2, DIM>& vec2)
 {
-    return { ((vec1.x==vec2.x) && (vec1.y==vec2.y) && (vec1.z==vec2.z))};
+    bool equal{1};
+    ppl::for_each_coord<DIM>([&](auto i){ 
+        equal = equal && (vec1.template get<i>() == vec2.template get<i>()); });
+    return equal;
 }
 
-template<typename T1, typename T2> 
-PPL_FUNC_DECL bool operator==(const ppl::vertex<T1>& vec, const T2& val)
+template<typename T1, typename T2, std::size_t DIM> 
+PPL_FUNC_DECL bool operator==(const ppl::vertex<T1, DIM>& vec, const T2& val)
 
 {
-    return { ((vec.x==val) && (vec.y==val) && (vec.z==val))};
+    bool equal{1};
+    ppl::for_each_coord<DIM>([&](auto i){ 
+        equal = equal && (vec.template get<i>() == val); });
+    return equal;
 }
 
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> operator^(ppl::vertex<T> vec, std::size_t __exp)
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> operator^(ppl::vertex<T, DIM> vec, std::size_t __exp)
 {
     if(__exp == 2){
-        return ppl::vertex<T>{vec.x*vec.x, vec.y*vec.y, vec.z*vec.z};
+        return vec*vec;
     }
     else
     {
-        ppl::vertex<T> temp{1, 1, 1};
+        ppl::vertex<T, DIM> temp(static_cast<T>(1));
         while (__exp > 1){
             if (__exp % 2 == 0)
                 __exp /= 2;
@@ -308,46 +384,60 @@ PPL_FUNC_DECL ppl::vertex<T> operator^(ppl::vertex<T> vec, std::size_t __exp)
     }
 }
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> operator-(const ppl::vertex<T>& vec)
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> operator-(const ppl::vertex<T, DIM>& vec)
 {
-    return {vec.x*(-1), vec.y*(-1), vec.z*(-1)};
+    if constexpr(ppl::__on_lanes<T, T, DIM>)
+        return ppl::__from_lanes<T, DIM>(vec.lanes() * static_cast<T>(-1));
+    else return ppl::make_vertex<T, DIM>([&](auto i){ return vec.template get<i>()*(-1); });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const ppl::vertex<T1>& vec1, const ppl::vertex<T2>& vec2) 
-    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const ppl::vertex<T1, DIM>& vec1, const ppl::vertex<T2, DIM>& vec2) 
+    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>
 {
-    return {vec1.x*vec2.x, vec1.y*vec2.y, vec1.z*vec2.z};
+    if constexpr(ppl::__on_lanes<T1, T2, DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec1.lanes() * vec2.lanes());
+    else return ppl::make_vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>(
+        [&](auto i){ return vec1.template get<i>()*vec2.template get<i>(); });
 }
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const ppl::vertex<T1>& vec, const T2& val) 
-    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const ppl::vertex<T1, DIM>& vec, const T2& val) 
+    -> ppl::vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>
 {
-    return {vec.x*val, vec.y*val, vec.z*val};
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T1>() * std::declval<T2>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec.lanes() * static_cast<T1>(val));
+    else return ppl::make_vertex<decltype(std::declval<T1>() * std::declval<T2>()), DIM>(
+        [&](auto i){ return vec.template get<i>()*val; });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator*(const T2& val, const ppl::vertex<T1>& vec)
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator*(const T2& val, const ppl::vertex<T1, DIM>& vec)
 {
     return vec*val;
 }
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const ppl::vertex<T1>& vec1, const ppl::vertex<T2>& vec2) 
-    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const ppl::vertex<T1, DIM>& vec1, const ppl::vertex<T2, DIM>& vec2) 
+    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>
 {
-    return {vec1.x+vec2.x, vec1.y+vec2.y, vec1.z+vec2.z};
+    if constexpr(ppl::__on_lanes<T1, T2, DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec1.lanes() + vec2.lanes());
+    else return ppl::make_vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>(
+        [&](auto i){ return vec1.template get<i>()+vec2.template get<i>(); });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const ppl::vertex<T1>& vec, const T2& val) 
-    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const ppl::vertex<T1, DIM>& vec, const T2& val) 
+    -> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>
 {
-    return {vec.x+val, vec.y+val, vec.z+val};
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T1>() + std::declval<T2>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec.lanes() + static_cast<T1>(val));
+    else return ppl::make_vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>(
+        [&](auto i){ return vec.template get<i>()+val; });
 }
 
 
@@ -356,63 +446,91 @@ PPL_FUNC_DECL auto operator+(const ppl::vertex<T1>& vec, const T2& val)
 //    {
 //        return vec+val;
 //    }
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator+(const T2& val, const ppl::vertex<T1>& vec)
--> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator+(const T2& val, const ppl::vertex<T1, DIM>& vec)
+-> ppl::vertex<decltype(std::declval<T1>() + std::declval<T2>()), DIM>
 {
-	return { vec.x + val, vec.y + val, vec.z + val };
+	return vec + val;
 }
 
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const ppl::vertex<T1>& vec1, const ppl::vertex<T2>& vec2) 
-    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const ppl::vertex<T1, DIM>& vec1, const ppl::vertex<T2, DIM>& vec2) 
+    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>
 {
-    return {vec1.x-vec2.x, vec1.y-vec2.y, vec1.z-vec2.z};
+    if constexpr(ppl::__on_lanes<T1, T2, DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec1.lanes() - vec2.lanes());
+    else return ppl::make_vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>(
+        [&](auto i){ return vec1.template get<i>()-vec2.template get<i>(); });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const ppl::vertex<T1>& vec, const T2& val) 
-    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const ppl::vertex<T1, DIM>& vec, const T2& val) 
+    -> ppl::vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>
 {
-    return {vec.x-val, vec.y-val, vec.z-val};
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T1>() - std::declval<T2>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec.lanes() - static_cast<T1>(val));
+    else return ppl::make_vertex<decltype(std::declval<T1>() - std::declval<T2>()), DIM>(
+        [&](auto i){ return vec.template get<i>()-val; });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator-(const T2& val, const ppl::vertex<T1>& vec) 
-    -> ppl::vertex<decltype(std::declval<T2>() - std::declval<T1>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator-(const T2& val, const ppl::vertex<T1, DIM>& vec) 
+    -> ppl::vertex<decltype(std::declval<T2>() - std::declval<T1>()), DIM>
 {
-    return {val-vec.x, val-vec.y, val-vec.z};
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T2>() - std::declval<T1>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(static_cast<T1>(val) - vec.lanes());
+    else return ppl::make_vertex<decltype(std::declval<T2>() - std::declval<T1>()), DIM>(
+        [&](auto i){ return val-vec.template get<i>(); });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const ppl::vertex<T1>& vec1, const ppl::vertex<T2>& vec2) 
-    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const ppl::vertex<T1, DIM>& vec1, const ppl::vertex<T2, DIM>& vec2) 
+    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>
 {
-    return {vec1.x/vec2.x, vec1.y/vec2.y, vec1.z/vec2.z};
+    if constexpr(ppl::__on_lanes<T1, T2, DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec1.lanes() / ppl::__divisor_lanes(vec2.lanes()));
+    else return ppl::make_vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>(
+        [&](auto i){ return vec1.template get<i>()/vec2.template get<i>(); });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const ppl::vertex<T1>& vec, const T2& val) 
-    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const ppl::vertex<T1, DIM>& vec, const T2& val) 
+    -> ppl::vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>
 {
-    return {vec.x/val, vec.y/val, vec.z/val};
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T1>() / std::declval<T2>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(vec.lanes() / static_cast<T1>(val));
+    else return ppl::make_vertex<decltype(std::declval<T1>() / std::declval<T2>()), DIM>(
+        [&](auto i){ return vec.template get<i>()/val; });
 }
 
-template<typename T1, typename T2>
-PPL_FUNC_DECL auto operator/(const T2& val, const ppl::vertex<T1>& vec) 
-    -> ppl::vertex<decltype(std::declval<T2>() / std::declval<T1>())>
+template<typename T1, typename T2, std::size_t DIM>
+PPL_FUNC_DECL auto operator/(const T2& val, const ppl::vertex<T1, DIM>& vec) 
+    -> ppl::vertex<decltype(std::declval<T2>() / std::declval<T1>()), DIM>
+{
+    if constexpr(ppl::__on_lanes<T1, decltype(std::declval<T2>() / std::declval<T1>()), DIM>)
+        return ppl::__from_lanes<T1, DIM>(static_cast<T1>(val) / ppl::__divisor_lanes(vec.lanes()));
+    else return ppl::make_vertex<decltype(std::declval<T2>() / std::declval<T1>()), DIM>(
+        [&](auto i){ return val/vec.template get<i>(); });
+}
+
+template<typename F, typename P_TYPE, std::size_t DIM, typename... T>
+PPL_FUNC_DECL auto fuse(F&& f, const ppl::vertex<P_TYPE, DIM>& vec, 
+            const ppl::vertex<T, DIM>&... vecs)
 {
-    return {val/vec.x, val/vec.y, val/vec.z};
+    using R = decltype(f(std::declval<P_TYPE>(), std::declval<T>()...));
+
+    return ppl::make_vertex<R, DIM>([&](auto i){ 
+        return f(vec.template get<i>(), vecs.template get<i>()...); });
 }
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> sqrt(const ppl::vertex<T>& vec){
-    return { std::sqrt(vec.x), std::sqrt(vec.y), std::sqrt(vec.z)};
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> sqrt(const ppl::vertex<T, DIM>& vec){
+    return ppl::make_vertex<T, DIM>([&](auto i){ return std::sqrt(vec.template get<i>()); });
 }
 
-template<typename T>
-PPL_FUNC_DECL ppl::vertex<T> normalize(const ppl::vertex<T> vec){
+template<typename T, std::size_t DIM>
+PPL_FUNC_DECL ppl::vertex<T, DIM> normalize(const ppl::vertex<T, DIM> vec){
     return vec/std::sqrt(vec.dot(vec));
 }
 
@@ -424,12 +542,3 @@ PPL_FUNC_DECL auto cross(const ppl::vertex<T1>& vec1, const ppl::vertex<T2>& vec
 			vec1.z * vec2.x - vec2.z * vec1.x,
 			vec1.x * vec2.y - vec2.x * vec1.y};
 }
-
-
-
-
-
-
-
-
-
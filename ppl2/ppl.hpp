@@ -49,8 +49,20 @@
 
 
 #include "include/ppl_vertex.hpp"
+#include "include/ppl_arena.hpp"
+#include "include/ppl_packed_track.hpp"
 #include "include/ppl_LERPer.hpp"
 #include "include/ppl_projection.hpp"
+#include "include/ppl_tiled_path.hpp"
+#include "include/ppl_bezier_path.hpp"
+#include "include/ppl_segment_path.hpp"
+#include "include/ppl_bspline_path.hpp"
+#include "include/ppl_track_handle.hpp"
+#include "include/ppl_track_watcher.hpp"
+#include "include/ppl_tile_store.hpp"
+#include "include/ppl_shared_track.hpp"
+#include "include/ppl_projection_service.hpp"
+#include "include/ppl_sharded_projection.hpp"
 
 
 
@@ -0,0 +1,88 @@
+
+
+//  Copyright (C) 2007 Free Software Foundation, Inc. <https://fsf.org/>
+//  
+//  This file is part of the Point Projection Library (ppl).
+//  
+//  Distributed under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; You should have
+//  received a copy of the GNU General Public License.
+//  If not, see <http://www.gnu.org/licenses/>.
+//  
+//  
+//  This library is distributed in the hope that it will be useful, but WITHOUT
+//  WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//  WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, TITLE AND
+//  NON-INFRINGEMENT. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR ANYONE
+//  DISTRIBUTING THE SOFTWARE BE LIABLE FOR ANY DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. See the GNU
+//  General Public License for more details.
+
+
+
+/*
+ * Copyright Abbas M.Murrey 2019-21
+ *
+ * Permission to use, copy, modify, distribute and sell this software
+ * for any purpose is hereby granted without fee, provided that the
+ * above copyright notice appear in all copies and that both the copyright
+ * notice and this permission notice appear in supporting documentation.  
+ * I make no representations about the suitability of this software for any
+ * purpose.  It is provided "as is" without express or implied warranty.
+ *
+ */
+
+
+
+
+/*
+ * A standalone projection server. It loads a file of control points once
+ * and answers the projections asked by the processes of the host, see
+ * ppl::projection_server. Build it from this directory with:
+ *
+ *   g++ -std=c++17 -O2 -pthread -DPPL_CONCURRENCY -DPPL_EXTERNAL_TRACK_LOADING \
+ *       -DPPL_PROJECTION_SERVICE projection_server.cpp -o projection_server -lstdc++fs
+ *
+ * Usage: projection_server <control points file> <socket> [window in microseconds]
+ */
+
+#include <csignal>
+#include "../ppl.hpp"
+
+
+static ppl::projection_server<double>* server{nullptr};
+
+extern "C" void on_signal(int){
+    if(server != nullptr)
+        server->stop();
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 3 || argc > 4){
+        std::cerr << "usage: " << argv[0] << " <control points file> <socket> [window in microseconds]\n";
+        return 2;
+    }
+
+    try{
+        ppl::point_projection<double> path(argv[1]);
+        const std::chrono::microseconds window{argc == 4? std::stol(argv[3]) : 200};
+
+        ppl::projection_server<double> _server(argv[2], path, window);
+        server = &_server;
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+
+        std::cerr << "serving <" << argv[1] << "> on <" << argv[2] << ">\n";
+        _server.run();
+        server = nullptr;
+
+        std::cerr << _server.clients() << " clients, " << _server.requests() << " requests, " 
+                  << _server.points() << " points in " << _server.batches() << " batches\n";
+    }catch(const std::exception& e){
+        std::cerr << e.what();
+        return 1;
+    }
+    return 0;
+}